@@ -0,0 +1,139 @@
+// Chunk storage benchmark: compute, edit and renderer read paths plus section storage.
+// Each run appends one line to bench_output.txt:
+//   g++ -std=c++20 bench_layout.cpp -O3 -DNDEBUG -Isrc/Include -Lsrc/lib -lSDL3 -o bench_layout
+// Add -DSIM_TEMP_STORAGE=1 (fp16) or =2 (unorm16) to compare temperature storage modes.
+// Usage: bench_layout [--grid N] [--frames F] [--threads T] [--pin] [--seed S] [--sparse] [--calm] [--sleep-eps E] [--implicit] [--multirate] [--in-place] [--halo] [--dt S] [--steady] [--stencil cell|flux]
+//   --pin:    pin the section workers to the allowed CPUs (see SimWorkerPool)
+//   --halo:   exchange the x/z borders into ghost layers before the kernels (World::haloExchange)
+//   --steady: also time solve_steady_state on a fresh copy of the world (cells at y=0 pinned)
+//   --sparse: one filled section per chunk (surface-like world) instead of all 24
+//   --calm:   every section at 300 K with the hot cells only in sy=8, so most sections stay uniform
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <chrono>
+
+#include "sim_engine.hpp"
+#include "sim_render.hpp"   // chunk_minmax_nonvoid / slice_minmax_nonvoid (renderer read paths)
+
+using bench_clock = std::chrono::steady_clock;
+
+template<class F> static double time_ms(F&& f) {
+    auto t0 = bench_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - t0).count();
+}
+
+// Grid x grid chunks, every section (or only sy=8 when sparse) filled with a random material;
+// a few random hot cells.
+static void build_world(World& world, int grid, uint32_t seed, bool sparse, bool calm) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> d_heatCap(200.f, 1200.f);
+    std::uniform_real_distribution<float> d_k(1.f, 500.f);
+    std::uniform_real_distribution<float> d_mass(500.f, 4000.f);
+    std::uniform_real_distribution<float> d_temp(0.f, 6000.f);
+
+    world.materials.add(Material{0.0f, 0.0f, 0.0f, 0.0f}); // VOID
+    for (int m=0; m<64; ++m) world.materials.add(Material{ d_heatCap(rng), d_k(rng), d_mass(rng), 0.05f });
+
+    for (int cz=0; cz<grid; ++cz) {
+        for (int cx=0; cx<grid; ++cx) {
+            Chunk* C = world.ensureChunk(cx, cz);
+            for (int sy=0; sy<SECTIONS_Y; ++sy)
+                if (!sparse || sy == 8) fill_section_with(*C, uint16_t(1 + rng() % 64), calm ? 300.0f : d_temp(rng), sy, world.materials);
+            for (int h=0; h<64; ++h) {
+                const int y = (sparse || calm) ? 8*SECTION_EDGE + int(rng() % SECTION_EDGE) : int(rng() % CHUNK_H);
+                set_cell(*C, int(rng() % CHUNK_W), y, int(rng() % CHUNK_D), 1, 6000.0f, world.materials);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int grid = 4, frames = 50, threads = 1;
+    uint32_t seed = 12345;
+    bool sparse = false, calm = false;
+    float sleepEps = 0.0f, dt = 1.0f;
+    SimSolver solver = SimSolver::Explicit;
+    bool steady = false, inPlace = false, pin = false, halo = false;
+    for (int i=1; i<argc; ++i) {
+        if      (std::strcmp(argv[i], "--grid")==0    && i+1<argc) grid    = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--frames")==0  && i+1<argc) frames  = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads")==0 && i+1<argc) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--pin")==0)                  pin     = true;
+        else if (std::strcmp(argv[i], "--seed")==0    && i+1<argc) seed    = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--sparse")==0)               sparse  = true;
+        else if (std::strcmp(argv[i], "--calm")==0)                 calm    = true;
+        else if (std::strcmp(argv[i], "--sleep-eps")==0 && i+1<argc) sleepEps = (float)std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--implicit")==0)             solver  = SimSolver::ImplicitPCG;
+        else if (std::strcmp(argv[i], "--multirate")==0)            solver  = SimSolver::MultiRate;
+        else if (std::strcmp(argv[i], "--in-place")==0)             inPlace = true;
+        else if (std::strcmp(argv[i], "--halo")==0)                 halo    = true;
+        else if (std::strcmp(argv[i], "--dt")==0      && i+1<argc) dt      = (float)std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--steady")==0)               steady  = true;
+        else if (std::strcmp(argv[i], "--stencil")==0 && i+1<argc)
+            active_sim_stencil() = std::strcmp(argv[++i], "cell")==0 ? SimStencil::Cell : SimStencil::Flux;
+    }
+
+    World world;
+    build_world(world, grid, seed, sparse, calm);
+    world.sleep.epsilon = sleepEps;
+    world.solver = solver;
+    world.inPlace = inPlace;
+    world.haloExchange = halo;
+    SimWorkerPool pool(threads, pin);
+
+    step_frame(world, dt, &pool); // warm-up: coefficient rebuild + first touch
+
+    const double compute_ms = time_ms([&]{
+        for (int f=0; f<frames; ++f) step_frame(world, dt, &pool);
+    }) / frames;
+
+    const SectionActivity act = world_section_activity(world);  // after the timed frames
+    const size_t sections = act.awake + act.asleep + act.uniform;
+    const double storage_mib = world_storage_bytes(world) / 1048576.0;
+
+    double fill_ms = 0.0, loaded_ms = 0.0, minmax_ms = 0.0, slice_ms = 0.0;
+    float sink = 0.0f; // keeps the read passes observable
+    std::mt19937 rng(seed);
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        minmax_ms += time_ms([&]{ if (auto mm = chunk_minmax_nonvoid(C)) sink += mm->first; });
+        slice_ms  += time_ms([&]{ for (int z=0; z<CHUNK_D; ++z) sink += slice_minmax_nonvoid(C, z).second; });
+        loaded_ms += time_ms([&]{ recomputeSectionLoaded(C); });
+        fill_ms   += time_ms([&]{
+            for (int sy=0; sy<SECTIONS_Y; ++sy)
+                if (C.sectionLoaded[sy]) fill_section_with(C, uint16_t(1 + rng() % 64), 300.0f, sy, world.materials);
+        });
+    }
+
+    const double cells = double(sections) * SECTION_N;
+    char line[512];
+    std::snprintf(line, sizeof(line),
+        "%-6s temp=%-7s kernel=%-6s stencil=%s solver=%s%s%s (dt=%g s, cg it=%d) threads=%d chunks=%zu sections=%zu (uniform %zu, asleep %zu) storage=%.2f MiB  compute=%.3f ms/frame (%.1f Mcells/s)  "
+        "fill=%.3f ms  sectionLoaded=%.3f ms  minmax=%.3f ms  slices=%.3f ms  [%g]\n",
+        sparse ? "sparse" : calm ? "calm" : "dense", TEMP_STORAGE_NAME, sim_kernel_name(active_sim_kernel()), sim_stencil_name(active_sim_stencil()),
+        sim_solver_name(solver), inPlace ? " in-place" : "", halo ? " halo" : "", (double)dt, world.implicitLast.iterations, pool.size(), world.chunks.size(), sections, act.uniform, act.asleep,
+        storage_mib,
+        compute_ms, cells / (compute_ms * 1000.0), fill_ms, loaded_ms, minmax_ms, slice_ms, (double)sink);
+    std::fputs(line, stdout);
+    if (FILE* f = std::fopen("bench_output.txt", "a")) { std::fputs(line, f); std::fclose(f); }
+
+    if (steady) {
+        World sw;
+        build_world(sw, grid, seed, sparse, calm);
+        SteadyStateConfig cfg;
+        cfg.pinned = [](const Chunk&, int, int y, int) { return y == 0; };
+        SteadyStateStats st;
+        const double steady_ms = time_ms([&]{ st = solve_steady_state(sw, cfg, &pool); });
+        std::snprintf(line, sizeof(line),
+            "steady: %.1f ms  cells=%zu (multigrid %zu, floating %zu in %zu regions)  iterations=%d converged=%d  residual %.3g -> %.3g W (max %.3g W)\n",
+            steady_ms, st.cells, st.solvedCells, st.floatingCells, st.floatingRegions, st.iterations, st.converged ? 1 : 0,
+            st.residual0, st.residual, st.maxResidual);
+        std::fputs(line, stdout);
+        if (FILE* f = std::fopen("bench_output.txt", "a")) { std::fputs(line, f); std::fclose(f); }
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// step_frame consistency check: runs the same edited world through every kernel variant the CPU
+// supports, both stencils, several pool sizes, with/without inPlace, with/without the halo
+// exchange and with/without published temperature buffers (held for two frames, as snapshots
+// would), hashes the temperatures after each run and compares them with the first run (scalar,
+// cell, 1 thread, T_next, no halo). All of them must be bit for bit identical; differing runs are
+// marked MISMATCH and the exit code is 1.
+//   g++ -std=c++20 check_step.cpp -O3 -DNDEBUG -Isrc/Include -Lsrc/lib -lSDL3 -o check_step
+// Add -DSIM_TEMP_STORAGE=1 (fp16) or =2 (unorm16) to check the other temperature storage modes.
+// Usage: check_step [--frames F] [--seed S]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "sim_engine.hpp"
+
+static constexpr int GRID = 3;   // GRID x GRID chunks, the last corner left unloaded
+
+// Random sections (some uniform, some missing), a zero-conductivity material and random cells,
+// so uniform promotion, void cells and missing neighbors are all exercised.
+static void build_world(World& world, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> d_heatCap(200.f, 1200.f);
+    std::uniform_real_distribution<float> d_k(1.f, 500.f);
+    std::uniform_real_distribution<float> d_mass(500.f, 4000.f);
+    std::uniform_real_distribution<float> d_temp(0.f, 6000.f);
+
+    world.materials.add(Material{0.0f, 0.0f, 0.0f, 0.0f}); // VOID
+    for (int m=0; m<20; ++m) world.materials.add(Material{ d_heatCap(rng), d_k(rng), d_mass(rng), 0.05f });
+    world.materials.add(Material{500.0f, 0.0f, 1000.0f, 0.05f}); // insulator
+
+    for (int cz=0; cz<GRID; ++cz) {
+        for (int cx=0; cx<GRID; ++cx) {
+            if (cx == GRID-1 && cz == GRID-1) continue;
+            Chunk* C = world.ensureChunk(cx, cz);
+            for (int sy=0; sy<SECTIONS_Y; ++sy)
+                if (rng() % 3 == 0) fill_section_with(*C, uint16_t(1 + rng() % 21), d_temp(rng), sy, world.materials);
+            for (int e=0; e<400; ++e)
+                set_cell(*C, int(rng() % CHUNK_W), int(rng() % CHUNK_H), int(rng() % CHUNK_D),
+                         uint16_t(rng() % 22), float(rng() % 60000) / 10.0f, world.materials);
+        }
+    }
+}
+
+// A few cell edits between frames, as the server's drain phase would apply them.
+static void edit_world(World& world, std::mt19937& rng) {
+    for (int e=0; e<50; ++e) {
+        const int cx = int(rng() % GRID), cz = int(rng() % GRID);
+        if (Chunk* C = world.findChunk(cx, cz))
+            set_cell(*C, int(rng() % CHUNK_W), int(rng() % CHUNK_H), int(rng() % CHUNK_D),
+                     uint16_t(rng() % 22), float(rng() % 60000) / 10.0f, world.materials);
+    }
+}
+
+// FNV-1a over material and temperature bits of every non-void cell, chunks in a fixed order.
+static uint64_t hash_world(const World& world) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](uint32_t v) { h = (h ^ v) * 1099511628211ull; };
+    for (int cz=0; cz<GRID; ++cz)
+        for (int cx=0; cx<GRID; ++cx) {
+            const Chunk* C = world.findChunk(cx, cz);
+            if (!C) continue;
+            for (int y=0; y<CHUNK_H; ++y) for (int z=0; z<CHUNK_D; ++z) for (int x=0; x<CHUNK_W; ++x) {
+                const uint16_t m = C->matAt(x, y, z);
+                mix(m);
+                if (m == C->void_ix) continue;
+                const float T = C->TAt(x, y, z);
+                uint32_t bits;
+                std::memcpy(&bits, &T, sizeof(bits));
+                mix(bits);
+            }
+        }
+    return h;
+}
+
+// What publishing a snapshot does to the sections: shares every dense front buffer.
+static void share_world(World& world, std::vector<std::shared_ptr<const SectionTemps>>& held) {
+    held.clear();
+    for (auto& kv : world.chunks)
+        for (auto& S : kv.second->sections)
+            if (S && S->dense) held.push_back(S->T_curr.share());
+}
+
+static uint64_t run(int frames, uint32_t seed, int threads, bool inPlace, bool halo, bool publish) {
+    World world;
+    build_world(world, seed);
+    world.inPlace = inPlace;
+    world.haloExchange = halo;
+    SimWorkerPool pool(threads);
+    std::mt19937 rng(seed ^ 0x9e3779b9u);
+    std::vector<std::shared_ptr<const SectionTemps>> held[2];
+    for (int f=0; f<frames; ++f) {
+        step_frame(world, 1.0f, &pool);
+        if (publish) share_world(world, held[f & 1]);
+        if (f % 4 == 1) edit_world(world, rng);
+    }
+    return hash_world(world);
+}
+
+int main(int argc, char** argv) {
+    int frames = 16;
+    uint32_t seed = 7;
+    for (int i=1; i<argc; ++i) {
+        if      (std::strcmp(argv[i], "--frames")==0 && i+1<argc) frames = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed")==0   && i+1<argc) seed   = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    }
+
+    const int threadCounts[] = {1, 2, 4};
+    uint64_t ref = 0;
+    int runs = 0, bad = 0;
+    for (int k = 0; k <= (int)detect_sim_kernel(); ++k) {
+        set_sim_kernel(SimKernel(k));
+        for (SimStencil s : {SimStencil::Cell, SimStencil::Flux}) {
+            active_sim_stencil() = s;
+            for (int threads : threadCounts) {
+                for (int mode=0; mode<8; ++mode) {
+                    const bool inPlace = mode & 1, halo = mode & 2, publish = mode & 4;
+                    const uint64_t h = run(frames, seed, threads, inPlace, halo, publish);
+                    if (runs++ == 0) ref = h;
+                    const bool ok = (h == ref);
+                    bad += !ok;
+                    std::printf("temp=%-7s kernel=%-6s stencil=%-4s threads=%d%s%s%s  hash=%016llx %s\n",
+                        TEMP_STORAGE_NAME, sim_kernel_name(active_sim_kernel()), sim_stencil_name(s), threads,
+                        inPlace ? " in-place" : "         ", halo ? " halo" : "     ", publish ? " shared" : "       ",
+                        (unsigned long long)h, ok ? "ok" : "MISMATCH");
+                }
+            }
+        }
+    }
+    std::printf("%d runs, %d mismatching\n", runs, bad);
+    return bad ? 1 : 0;
+}
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <cstdlib>
 #include <random>
 #include <chrono>
 #include <thread>
@@ -9,9 +10,11 @@
 #include <mutex>
 #include <vector>
 #include <utility>
+#include <tuple>
+#include <array>
 #include <algorithm>
 
-#include "sim_server.hpp"   // start/stop/join, setPaused/isPaused, dtSeconds, sleepMillis, framesSimulated, world/worldMutex
+#include "sim_server.hpp"   // start/stop/join, setPaused/isPaused, dtSeconds, sleepMillis, tickRateHz/scheduleStats, framesSimulated, world/worldMutex
 #include "sim_render.hpp"   // run_world_ui(server)
 
 // ===============================
@@ -30,9 +33,9 @@ struct SpiralCursor {
     }
 };
 
-static int pick_empty_section(const Chunk& C, std::mt19937& rng) {
+static int pick_empty_section(const std::array<uint8_t, SECTIONS_Y>& loaded, std::mt19937& rng) {
     std::vector<int> empty; empty.reserve(SECTIONS_Y);
-    for (int sy=0; sy<SECTIONS_Y; ++sy) if (!C.sectionLoaded[sy]) empty.push_back(sy);
+    for (int sy=0; sy<SECTIONS_Y; ++sy) if (!loaded[sy]) empty.push_back(sy);
     if (empty.empty()) return -1;
     std::uniform_int_distribution<int> d(0, (int)empty.size()-1);
     return empty[d(rng)];
@@ -52,10 +55,7 @@ static void init_one_visible_section(SimServer& server) {
     fill_section_with(*c00, /*SOLID*/1, 300.0f, sy, server.world.materials); // NEW sig
 
     const int xMid = CHUNK_W/2, zMid = CHUNK_D/2, y0 = sy*SECTION_EDGE + SECTION_EDGE/2;
-    const int iHot = idx(xMid, y0, zMid);
-    c00->T_curr[iHot] = 6000.0f; c00->T_next[iHot] = 6000.0f;
-
-    recomputeSectionLoaded(*c00);
+    set_cell(*c00, xMid, y0, zMid, /*SOLID*/1, 6000.0f, server.world.materials);
 }
 
 // ===============================
@@ -84,38 +84,76 @@ static inline void print_progress_bar(double world_ms, double target_ms,
     }
 }
 
+static void print_schedule(const TickScheduleStats& st) {
+    std::printf("  schedule %.3f ms: %llu ticks, load %.1f%%, overruns %llu (late %llu, skipped %llu)\n",
+                st.periodMs, (unsigned long long)st.ticks, st.load() * 100.0, (unsigned long long)st.overruns,
+                (unsigned long long)st.late, (unsigned long long)st.skipped);
+    const std::pair<const char*, const TickHistogram*> rows[] = {
+        {"overrun", &st.overrun}, {"compute", &st.compute}, {"jitter", &st.jitter}, {"idle", &st.idle} };
+    for (const auto& [name, h] : rows)
+        std::printf("    %-8s p50 %8.3f  p99 %8.3f  max %8.3f ms\n", name, h->percentileMs(0.50), h->percentileMs(0.99), h->maxMs);
+}
+
 // ===============================
 // Unified stress-growth worker
 // ===============================
 struct StressGrowthWorker {
     SimServer& server;
     std::atomic<bool> stop{false};
-    std::atomic<bool> tripped{false};   // set once when world_ms > dt
+    std::atomic<bool> tripped{false};   // set once when world_ms > dt (or too many window overruns with tick_hz)
     uint32_t seed = std::random_device{}();
     double   dt_seconds = 1.0;
+    double   tick_hz = 0.0;             // > 0: budget is the server's fixed tick period
+    static constexpr uint64_t SCHEDULE_WINDOW = 256;        // ticks per budget check with tick_hz
+    static constexpr double   OVERRUN_FRACTION = 0.01;      // trip when more of the window's ticks overran
 
     // throttle progress bar updates
     std::chrono::steady_clock::time_point lastBar{};
     const std::chrono::milliseconds barInterval{100};
+    TickScheduleStats window{};         // tick_hz: last evaluated schedule window
 
     void print_summary_locked(uint32_t seedUsed, double world_ms) {
-        // Assumes caller holds worldMutex
+        // Assumes caller holds worldMutex and the sim thread is parked (setPaused(true))
         size_t chunks = server.world.chunks.size();
-        size_t sections_loaded = 0;
+        size_t sections_loaded = 0, sections_uniform = 0;
         double max_chunk = 0.0, sum_chunk = 0.0;
         for (const auto& kv : server.world.chunks) {
             const Chunk& C = *kv.second;
             max_chunk = std::max(max_chunk, C.chunk_ms_last);
             sum_chunk += C.chunk_ms_last;
-            for (int sy=0; sy<SECTIONS_Y; ++sy) sections_loaded += (C.sectionLoaded[sy] ? 1 : 0);
+            for (int sy=0; sy<SECTIONS_Y; ++sy) {
+                sections_loaded  += (C.sectionLoaded[sy] ? 1 : 0);
+                sections_uniform += (C.section(sy) && !C.section(sy)->dense ? 1 : 0);
+            }
         }
         std::printf("=== STRESS RESULT ===\n");
         std::printf("Seed: %u\n", seedUsed);
+        std::printf("Kernel: %s  (section workers: %d, temperature storage: %s)\n",
+                    sim_kernel_name(active_sim_kernel()), server.workerCount(), TEMP_STORAGE_NAME);
         std::printf("Target dt: %.3f ms\n", dt_seconds*1000.0);
+        std::printf("Solver: %s", sim_solver_name(server.world.solver));
+        if (server.world.solver == SimSolver::ImplicitPCG)
+            std::printf("  (last frame: %d CG iterations, residual %.2e, %zu cells)",
+                        server.world.implicitLast.iterations, (double)server.world.implicitLast.residual, server.world.implicitLast.cells);
+        if (server.world.solver == SimSolver::MultiRate)
+            std::printf("  (last frame: up to %d substeps, %zu section substeps)",
+                        server.world.multirateLast.maxSubsteps, server.world.multirateLast.sectionSteps);
+        std::printf("\n");
         std::printf("Total chunks: %zu\n", chunks);
-        std::printf("Total sections loaded: %zu (max per chunk: %d)\n", sections_loaded, SECTIONS_Y);
-        std::printf("World frame time: %.3f ms  (max chunk: %.3f ms, sum: %.3f ms)\n\n",
+        const SectionActivity act = world_section_activity(server.world);
+        std::printf("Total sections loaded: %zu (uniform: %zu, max per chunk: %d)\n", sections_loaded, sections_uniform, SECTIONS_Y);
+        std::printf("Dense sections: awake %zu, asleep %zu  (sleep eps: %g K, after %d frames)\n",
+                    act.awake, act.asleep, (double)server.world.sleep.epsilon, server.world.sleep.frames);
+        std::printf("Section storage: %.2f MiB  (dense would be %.2f MiB)\n",
+                    world_storage_bytes(server.world) / 1048576.0,
+                    chunks * (double)SECTIONS_Y * SECTION_BYTES / 1048576.0);
+        std::printf("World frame time: %.3f ms  (max chunk: %.3f ms, sum: %.3f ms)\n",
                     world_ms, max_chunk, sum_chunk);
+        if (tick_hz > 0.0) {
+            std::printf("Schedule, last %llu-tick window:\n", (unsigned long long)window.ticks);
+            print_schedule(window);
+        }
+        std::printf("\n");
         std::fflush(stdout);
     }
 
@@ -128,36 +166,54 @@ struct StressGrowthWorker {
         std::uniform_real_distribution<float> d_molar(0.01f, 0.10f);   // kg/mol
         std::uniform_real_distribution<float> d_temp(0.f, 6000.f);
 
+        // Growth goes through server.changes (applied by the sim thread between frames), so this
+        // worker tracks which sections of its current chunk it has filled instead of reading the chunk.
         SpiralCursor spiral;
-        Chunk* C = nullptr;
+        int cx = 0, cz = 0;
+        std::array<uint8_t, SECTIONS_Y> filled{};
         {
             std::unique_lock<std::mutex> lk(server.worldMutex);
-            C = server.world.ensureChunk(0,0);
+            if (const Chunk* C0 = server.world.findChunk(0,0)) filled = C0->sectionLoaded;
         }
 
         lastBar = steady_clock::now();
+        double p99_ms = 0.0;   // tick_hz: p99 sim lane time of the last full window
 
         while (!stop.load()) {
-            double world_ms = 0.0;
-            {
-                std::unique_lock<std::mutex> lk(server.worldMutex);
-                world_ms = world_total_ms_last(server.world); // sum of last per-chunk ms
+            const double world_ms = server.tickStats().worldMs;   // sum of last per-chunk ms
+
+            // With a tick rate the budget is real time: trip when more than OVERRUN_FRACTION of a
+            // window of SCHEDULE_WINDOW ticks missed their deadline, so a single late tick (a page
+            // fault, a preempted thread) does not end the run. Otherwise sum of chunk ms vs dt.
+            bool over = false;
+            if (tick_hz > 0.0) {
+                const TickScheduleStats st = server.scheduleStats();
+                if (st.ticks >= SCHEDULE_WINDOW) {
+                    window = st;
+                    p99_ms = st.compute.percentileMs(0.99);
+                    over = double(st.overruns) > OVERRUN_FRACTION * double(st.ticks);
+                    server.resetScheduleStats();
+                }
+            } else {
+                over = world_ms > dt_seconds * 1000.0;
             }
+            const double used_ms   = tick_hz > 0.0 ? p99_ms : world_ms;
+            const double budget_ms = tick_hz > 0.0 ? 1000.0 / tick_hz : dt_seconds * 1000.0;
 
             // progress bar (throttled)
             auto now = steady_clock::now();
             if (now - lastBar >= barInterval && !tripped.load()) {
-                print_progress_bar(world_ms, dt_seconds * 1000.0);
+                print_progress_bar(used_ms, budget_ms);
                 lastBar = now;
             }
 
             // Trip once: PAUSE sim, PRINT final bar + result, and STOP growth permanently
-            if (world_ms > dt_seconds * 1000.0) {
+            if (over) {
                 bool first = !tripped.exchange(true);
                 if (first) {
                     // show a final "100%" bar line before the summary
-                    print_progress_bar(world_ms, dt_seconds * 1000.0, 40, true);
-                    server.setPaused(true); // clean pause on the sim thread
+                    print_progress_bar(used_ms, budget_ms, 40, true);
+                    server.setPaused(true); // returns once the sim thread is parked, no compute in flight
                     std::unique_lock<std::mutex> lk(server.worldMutex);
                     print_summary_locked(seed, world_ms);
                 }
@@ -165,27 +221,19 @@ struct StressGrowthWorker {
                 break;
             }
 
-            // Grow one step
+            // Grow one step: a random empty section of the current chunk, else sy=8 of the next
+            // chunk on the spiral
             {
-                std::unique_lock<std::mutex> lk(server.worldMutex);
-                if (!C) C = server.world.ensureChunk(0,0);
-
-                int sy = pick_empty_section(*C, rng);
-                if (sy >= 0) {
-                    const uint16_t MAT = server.world.materials.add(
-                        Material{ d_heatCap(rng), d_k(rng), d_mass(rng), d_molar(rng) });
-                    fill_section_with(*C, MAT, d_temp(rng), sy, server.world.materials);
-                    recomputeSectionLoaded(*C);
-                } else {
-                    auto [ncx, ncz] = spiral.next();
-                    C = server.world.ensureChunk(ncx, ncz);
-                    C->void_ix = 0;
-                    const uint16_t MAT = server.world.materials.add(
-                        Material{ d_heatCap(rng), d_k(rng), d_mass(rng), d_molar(rng) });
-                    const int sy0 = 8;
-                    fill_section_with(*C, MAT, d_temp(rng), sy0, server.world.materials);
-                    recomputeSectionLoaded(*C);
+                int sy = pick_empty_section(filled, rng);
+                if (sy < 0) {
+                    std::tie(cx, cz) = spiral.next();
+                    filled.fill(0);
+                    sy = 8;
                 }
+                const uint16_t MAT = server.changes.addMaterial(
+                    Material{ d_heatCap(rng), d_k(rng), d_mass(rng), d_molar(rng) });
+                server.changes.fillSection(cx, cz, sy, MAT, d_temp(rng));
+                filled[sy] = 1;
             }
 
             std::this_thread::sleep_for(std::chrono::milliseconds(4));
@@ -196,15 +244,21 @@ struct StressGrowthWorker {
 // ===============================
 // Run stress (same sim+growth; render optional)
 // ===============================
-static int run_stress(bool attachRender, double dt_seconds, uint32_t seed) {
+static int run_stress(bool attachRender, double dt_seconds, uint32_t seed, int threads, float sleepEps, SimSolver solver, bool inPlace, double tickHz) {
     SimServer server;
     server.dtSeconds = (float)dt_seconds;       // used directly by server worker
+    server.workerThreads = threads;
+    server.world.sleep.epsilon = sleepEps;
+    server.world.solver = solver;
+    server.world.inPlace = inPlace;
     server.sleepMillis.store(1);
+    server.tickRateHz.store((float)tickHz);
     init_one_visible_section(server);
 
     StressGrowthWorker worker{server};
     worker.seed = seed;
     worker.dt_seconds = dt_seconds;
+    worker.tick_hz = tickHz;
 
     server.start();                              // starts background sim thread
     std::thread growThread(std::ref(worker));
@@ -237,29 +291,55 @@ static int run_stress(bool attachRender, double dt_seconds, uint32_t seed) {
 int main(int argc, char** argv) {
     bool headless = false;
     bool stress   = false;
+    int  threads  = 0;   // 0 = one section worker per allowed CPU
+    float sleepEps = 1e-3f; // K/frame; 0 = only exactly unchanged sections sleep, <0 = never sleep
+    double dt      = 1.0;   // simulated seconds per tick (also the stress frame budget)
+    SimSolver solver = SimSolver::Explicit;
+    bool inPlace   = false; // explicit frames update T_curr directly (no T_next)
+    double tickHz  = 0.0;   // fixed tick rate; 0 = free-running
 
     for (int i=1; i<argc; ++i) {
         if (std::strcmp(argv[i], "--headless")==0) headless = true;
         else if (std::strcmp(argv[i], "--stress")==0) stress = true;
+        else if (std::strcmp(argv[i], "--threads")==0 && i+1<argc) threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--sleep-eps")==0 && i+1<argc) sleepEps = (float)std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--dt")==0 && i+1<argc) dt = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--implicit")==0) solver = SimSolver::ImplicitPCG; // stable for dt of 10-60 s
+        else if (std::strcmp(argv[i], "--multirate")==0) solver = SimSolver::MultiRate;  // per-section substeps
+        else if (std::strcmp(argv[i], "--in-place")==0)  inPlace = true;
+        else if (std::strcmp(argv[i], "--tick-hz")==0 && i+1<argc) tickHz = std::atof(argv[++i]); // fixed-rate ticks
     }
 
     if (stress) {
         // Same stress logic; only toggle whether the render thread is attached
-        return run_stress(/*attachRender=*/!headless, /*dt_seconds=*/1.0, /*seed=*/std::random_device{}());
+        return run_stress(/*attachRender=*/!headless, dt, /*seed=*/std::random_device{}(), threads, sleepEps, solver, inPlace, tickHz);
     }
 
     // Normal interactive / headless (no stress workload)
     SimServer server;
-    server.dtSeconds = 1.0f;
+    server.dtSeconds = (float)dt;
+    server.workerThreads = threads;
+    server.world.sleep.epsilon = sleepEps;
+    server.world.solver = solver;
+    server.world.inPlace = inPlace;
+    server.tickRateHz.store((float)tickHz);
     init_one_visible_section(server);
     server.start();
 
     if (headless) {
-        std::puts("Headless server running. Press Ctrl+C to exit.");
+        std::printf("Headless server running (kernel=%s, solver=%s). Press Ctrl+C to exit.\n",
+                    sim_kernel_name(active_sim_kernel()), sim_solver_name(server.world.solver));
         while (true) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
             auto frames = server.framesSimulated.load();
-            std::printf("frames=%llu\n", (unsigned long long)frames);
+            std::printf("frames=%llu  edits/tick=%u (rejected %u, queue depth %u, dropped %llu)\n",
+                        (unsigned long long)frames, server.editsLastTick.load(), server.editsRejectedLastTick.load(),
+                        server.editDepthLastTick.load(), (unsigned long long)server.editsDropped());
+            const TickGraph::TickStats tt = server.tickTiming();
+            std::printf("  tick %llu: critical path %.3f ms, latency %.3f ms |", (unsigned long long)tt.tick, tt.criticalMs, tt.latencyMs);
+            for (const auto& ph : tt.phases) std::printf(" %s%s %.3f (wait %.3f)", ph.critical ? "*" : "", ph.name, ph.ms, ph.waitMs);
+            std::printf("\n");
+            if (tickHz > 0.0) print_schedule(server.scheduleStats());   // cumulative since start
         }
     }
 
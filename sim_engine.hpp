@@ -7,6 +7,25 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <SDL3/SDL_cpuinfo.h>
+#include "sim_pool.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define SIM_X86_SIMD 1
+  #include <immintrin.h>
+  #if defined(__GNUC__) || defined(__clang__)
+    // F16C ships on every AVX2/AVX-512 CPU, so the fp16 storage mode rides on these targets.
+    #define SIM_TARGET_AVX2   __attribute__((target("avx2,f16c")))
+    #define SIM_TARGET_AVX512 __attribute__((target("avx512f,f16c")))
+  #else
+    #define SIM_TARGET_AVX2
+    #define SIM_TARGET_AVX512
+  #endif
+#endif
 
 // ====== Dimensions (Minecraft-like): 16 x 384 x 16 per chunk ======
 constexpr int CHUNK_W = 16;   // X
@@ -21,7 +40,92 @@ constexpr int SECTIONS_Y = CHUNK_H / SECTION_EDGE;  // 24
 constexpr int SECTIONS_Z = CHUNK_D / SECTION_EDGE;  // 1
 static_assert(SECTIONS_X == 1 && SECTIONS_Z == 1, "Expected 16x384x16 chunk -> 1x24x1 sections");
 
-inline int idx(int x, int y, int z) { return x + y*CHUNK_W + z*CHUNK_W*CHUNK_H; }
+constexpr int SECTION_N = SECTION_EDGE * SECTION_EDGE * SECTION_EDGE;
+
+// ====== Cell layout ======
+// Each section is stored on its own as one contiguous brick: x fastest, then z, then y.
+// A section's fields fit in L2 and +-z neighbors are 64 B apart.
+constexpr int CELL_SX = 1, CELL_SZ = CHUNK_W, CELL_SY = CHUNK_W * CHUNK_D;
+static_assert((SECTION_EDGE & (SECTION_EDGE - 1)) == 0, "cell_ix masks y with SECTION_EDGE-1");
+
+// Index of cell (x, y, z) inside its section; y is a chunk coordinate, its section is y / SECTION_EDGE.
+inline int cell_ix(int x, int y, int z) { return x*CELL_SX + (y & (SECTION_EDGE-1))*CELL_SY + z*CELL_SZ; }
+
+// Visits every (y, z) X-row of section sy in memory order.
+template<class F> inline void for_each_section_row(int sy, F&& f) {
+    const int y0 = sy * SECTION_EDGE;
+    for (int y=y0; y<y0+SECTION_EDGE; ++y) for (int z=0; z<CHUNK_D; ++z) f(y, z);
+}
+
+// ====== Temperature storage (compile-time; compute is always fp32) ======
+// SIM_TEMP_F16: IEEE half via F16C in the SIMD kernels. Step is 4 K near 6000 K, 0.25 K near 300 K;
+//               per-frame changes below half a step are lost.
+// SIM_TEMP_U16: unorm16 over the clamp range [0, 6000] K, a uniform 0.092 K step.
+// Both halve the T_curr/T_next traffic of the stencil and clamp to [0, 6000] on store; fp32 stores as is.
+#define SIM_TEMP_F32 0
+#define SIM_TEMP_F16 1
+#define SIM_TEMP_U16 2
+#ifndef SIM_TEMP_STORAGE
+  #define SIM_TEMP_STORAGE SIM_TEMP_F32
+#endif
+
+constexpr float SIM_T_MAX = 6000.0f;
+
+// Round-to-nearest-even, same as F16C's vcvtps2ph with _MM_FROUND_TO_NEAREST_INT.
+inline uint16_t f32_to_f16(float f) {
+    uint32_t x; std::memcpy(&x, &f, 4);
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    x &= 0x7fffffffu;
+    if (x >= 0x47800000u) return uint16_t(sign | (x > 0x7f800000u ? 0x7e00u : 0x7c00u)); // >= 65536, inf, nan
+    if (x < 0x38800000u) {                                                                 // half subnormal
+        if (x < 0x33000000u) return uint16_t(sign);
+        const uint32_t m = (x & 0x7fffffu) | 0x800000u;
+        const int shift = 126 - int(x >> 23);
+        uint32_t h = m >> shift;
+        const uint32_t rem = m & ((1u << shift) - 1), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1u))) ++h;
+        return uint16_t(sign | h);
+    }
+    uint32_t h = (x - 0x38000000u) >> 13;
+    const uint32_t rem = x & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h;  // carry into the exponent is correct
+    return uint16_t(sign | h);
+}
+inline float f16_to_f32(uint16_t h) {
+    const uint32_t sign = uint32_t(h & 0x8000u) << 16;
+    uint32_t e = (h >> 10) & 0x1fu, m = h & 0x3ffu, x;
+    if (e == 0x1fu)  x = sign | 0x7f800000u | (m << 13);
+    else if (e)      x = sign | ((e + 112u) << 23) | (m << 13);
+    else if (!m)     x = sign;
+    else {
+        e = 113;
+        while (!(m & 0x400u)) { m <<= 1; --e; }
+        x = sign | (e << 23) | ((m & 0x3ffu) << 13);
+    }
+    float f; std::memcpy(&f, &x, 4);
+    return f;
+}
+
+#if SIM_TEMP_STORAGE == SIM_TEMP_F32
+using temp_t = float;
+constexpr const char* TEMP_STORAGE_NAME = "fp32";
+inline float  temp_decode(temp_t t) { return t; }
+inline temp_t temp_encode(float T)  { return T; }
+#elif SIM_TEMP_STORAGE == SIM_TEMP_F16
+using temp_t = uint16_t;
+constexpr const char* TEMP_STORAGE_NAME = "fp16";
+inline float  temp_decode(temp_t t) { return f16_to_f32(t); }
+inline temp_t temp_encode(float T)  { return f32_to_f16(std::min(std::max(T, 0.0f), SIM_T_MAX)); }
+#elif SIM_TEMP_STORAGE == SIM_TEMP_U16
+using temp_t = uint16_t;
+constexpr const char* TEMP_STORAGE_NAME = "unorm16";
+constexpr float TEMP_U16_STEP = SIM_T_MAX / 65535.0f;   // K per code
+constexpr float TEMP_U16_INV  = 65535.0f / SIM_T_MAX;
+inline float  temp_decode(temp_t t) { return float(t) * TEMP_U16_STEP; }
+inline temp_t temp_encode(float T)  { return temp_t(std::nearbyint(std::min(std::max(T, 0.0f), SIM_T_MAX) * TEMP_U16_INV)); }
+#else
+  #error "SIM_TEMP_STORAGE must be SIM_TEMP_F32, SIM_TEMP_F16 or SIM_TEMP_U16"
+#endif
 
 // ====== Materials (indexed to save memory) ======
 struct Material {
@@ -43,17 +147,292 @@ struct MaterialLUT {
     void   clear() noexcept { table.clear(); }
 };
 
-// ====== Chunk ======
-struct Chunk {
-    std::array<uint16_t, CHUNK_N> matIx{};  // material index per cell (0=void recommended)
+// ====== Palette-compressed material indices (one per section) ======
+// Cells store an index into a small per-section palette, bit-packed at 0/1/2/4/8 bits per cell
+// (16 once a section holds more than 256 distinct materials). 0 bits = single-value section,
+// no per-cell words at all. Widths divide 64 and a 16-cell X row is 16..256 bits, so a cell
+// never straddles a word and a row decodes from at most four words.
+// Palette entries are only appended by set(); fill() and compact() drop unused ones.
+class SectionPalette {
+public:
+    explicit SectionPalette(uint16_t value) : palette{value} {}
+
+    uint16_t get(int i) const {
+        if (bpc == 0) return palette[0];
+        const int bit = i * bpc;
+        return palette[(words[bit >> 6] >> (bit & 63)) & mask()];
+    }
+    void set(int i, uint16_t mat) {
+        int p = find(mat);
+        if (p < 0) {
+            if (palette.size() >= (size_t(1) << bpc)) repack(width_for(palette.size() + 1));
+            palette.push_back(mat);
+            p = (int)palette.size() - 1;
+        }
+        if (bpc == 0) return;  // p == 0: single value unchanged
+        const int bit = i * bpc;
+        uint64_t& w = words[bit >> 6];
+        w = (w & ~(mask() << (bit & 63))) | (uint64_t(p) << (bit & 63));
+    }
+    void fill(uint16_t mat) {
+        palette.assign(1, mat);
+        words.clear(); words.shrink_to_fit();
+        bpc = 0;
+    }
+
+    // CHUNK_W materials of the X row starting at cell `base` (a cell_ix(0,y,z)).
+    void decode_row(int base, uint16_t* out) const {
+        if (bpc == 0) { std::fill(out, out + CHUNK_W, palette[0]); return; }
+        const uint64_t m = mask();
+        int bit = base * bpc;
+        for (int x=0; x<CHUNK_W; ++x, bit += bpc) out[x] = palette[(words[bit >> 6] >> (bit & 63)) & m];
+    }
+
+    bool contains(uint16_t mat) const { return find(mat) >= 0; }
+    bool uniform() const { return bpc == 0; }
+    int  bits() const { return bpc; }
+    const std::vector<uint16_t>& entries() const { return palette; }
+    size_t bytes() const { return palette.capacity() * sizeof(uint16_t) + words.capacity() * sizeof(uint64_t); }
+
+    // Counts cells that are not `skip` and rebuilds the palette from the entries still in use.
+    int compact(uint16_t skip) {
+        if (bpc == 0) return palette[0] != skip ? SECTION_N : 0;
+        std::vector<int> used(palette.size(), 0);
+        for (int i=0; i<SECTION_N; ++i) ++used[raw(i)];
+        std::vector<uint16_t> remap(palette.size(), 0);
+        std::vector<uint16_t> kept;
+        int counted = 0;
+        for (size_t p=0; p<palette.size(); ++p) {
+            if (!used[p]) continue;
+            remap[p] = (uint16_t)kept.size();
+            kept.push_back(palette[p]);
+            if (palette[p] != skip) counted += used[p];
+        }
+        if (kept.size() != palette.size()) {
+            const int nb = width_for(kept.size());
+            std::vector<uint64_t> nw(words_for(nb), 0);
+            for (int i=0; nb && i<SECTION_N; ++i) {
+                const int bit = i * nb;
+                nw[bit >> 6] |= uint64_t(remap[raw(i)]) << (bit & 63);
+            }
+            palette = std::move(kept);
+            words = std::move(nw);
+            bpc = (uint8_t)nb;
+        }
+        return counted;
+    }
+
+private:
+    uint64_t mask() const { return (uint64_t(1) << bpc) - 1; }
+    uint16_t raw(int i) const { const int bit = i * bpc; return uint16_t((words[bit >> 6] >> (bit & 63)) & mask()); }
+    int find(uint16_t mat) const {
+        for (size_t p=0; p<palette.size(); ++p) if (palette[p] == mat) return (int)p;
+        return -1;
+    }
+    static int width_for(size_t entries) {
+        if (entries <= 1)   return 0;
+        if (entries <= 2)   return 1;
+        if (entries <= 4)   return 2;
+        if (entries <= 16)  return 4;
+        if (entries <= 256) return 8;
+        return 16;
+    }
+    static size_t words_for(int b) { return size_t(SECTION_N) * b / 64; }
+    void repack(int nb) {
+        std::vector<uint64_t> nw(words_for(nb), 0);
+        for (int i=0; bpc && i<SECTION_N; ++i) {
+            const int bit = i * nb;
+            nw[bit >> 6] |= uint64_t(raw(i)) << (bit & 63);
+        }
+        words = std::move(nw);
+        bpc = (uint8_t)nb;
+    }
 
-    // Temperatures
-    std::vector<float> T_curr; // K (front buffer)
-    std::vector<float> T_next; // K (back buffer)
+    std::vector<uint16_t> palette;   // distinct materials, indexed by the packed values
+    std::vector<uint64_t> words;     // SECTION_N * bpc bits, cell i at bit i*bpc
+    uint8_t bpc = 0;                 // bits per cell: 0,1,2,4,8,16
+};
+
+// ====== Ghost layers (one per dense section that runs) ======
+// Copies of the horizontal neighbor sections' border cells, plus the faces those neighbors own
+// toward this section, refreshed by exchange_section_halo before every kernel pass. Only kept
+// with World::haloExchange; the section kernels then read the other chunks only through here
+// (a boundary for sharding the world). Missing neighbors read as 0 K and k = 0.
+struct SectionHalo {
+    alignas(64) std::array<temp_t, SECTION_EDGE*CHUNK_W> zn{}, zp{};  // z=15 row of (cx,cz-1) / z=0 row of (cx,cz+1), [y][x]
+    alignas(64) std::array<float,  SECTION_EDGE*CHUNK_W> kzn{};       // faces (cx,cz-1) owns toward this section, [y][x]
+    alignas(64) std::array<temp_t, SECTION_EDGE*CHUNK_D> xn{}, xp{};  // x=15 cell of (cx-1,cz) / x=0 cell of (cx+1,cz), [y][z]
+    alignas(64) std::array<float,  SECTION_EDGE*CHUNK_D> kxn{};       // faces (cx-1,cz) owns toward this section, [y][z]
+
+    static int row(int y)        { return (y & (SECTION_EDGE-1)) * CHUNK_W; }
+    static int col(int y, int z) { return (y & (SECTION_EDGE-1)) * CHUNK_D + z; }
+};
 
-    // NEW: mass map (kg per 1 m^3 cell)
+// ====== Section temperature buffers (pooled, shared with snapshots) ======
+// A dense section keeps its temperatures in pooled SECTION_N buffers. Publishing a frame hands the
+// front buffer to the snapshot (share()) instead of copying it; a shared buffer is never written
+// again, so the next write moves the section to a fresh pool buffer (writable), copying the cells
+// only when the write is partial. Buffers go back to the pool when the last holder drops them.
+struct SectionTemps { alignas(64) std::array<temp_t, SECTION_N> v; };
+
+class SectionTempsPool : public std::enable_shared_from_this<SectionTempsPool> {
+public:
+    ~SectionTempsPool() { for (SectionTemps* p : free_) delete p; }
+    std::shared_ptr<SectionTemps> acquire() {
+        SectionTemps* p = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!free_.empty()) { p = free_.back(); free_.pop_back(); }
+        }
+        if (!p) p = new SectionTemps;
+        // The deleter keeps the pool alive for buffers that outlive it (snapshots, statics).
+        return std::shared_ptr<SectionTemps>(p, [pool = shared_from_this()](SectionTemps* q) { pool->recycle(q); });
+    }
+private:
+    void recycle(SectionTemps* p) { std::lock_guard<std::mutex> lk(m_); free_.push_back(p); }
+    std::mutex m_;
+    std::vector<SectionTemps*> free_;
+};
+inline SectionTempsPool& section_temps_pool() {
+    static const std::shared_ptr<SectionTempsPool> pool = std::make_shared<SectionTempsPool>();
+    return *pool;
+}
+
+// T_curr/T_next of a dense section (empty otherwise). Reads are const; writes go through
+// writable(keep), which first unshares a published buffer (keep = copy the cells over).
+class SectionTempBuffer {
+public:
+    SectionTempBuffer() = default;
+    SectionTempBuffer(SectionTempBuffer&&) = default;
+    SectionTempBuffer& operator=(SectionTempBuffer&&) = default;
+    SectionTempBuffer(const SectionTempBuffer&) = delete;
+    SectionTempBuffer& operator=(const SectionTempBuffer&) = delete;
+
+    bool          empty() const          { return !buf_; }
+    size_t        size()  const          { return buf_ ? SECTION_N : 0; }
+    const temp_t* data()  const          { return buf_->v.data(); }
+    temp_t        operator[](int i) const { return buf_->v[i]; }
+
+    temp_t* writable(bool keep = true) {
+        if (buf_ && !shared_) return buf_->v.data();
+        std::shared_ptr<SectionTemps> fresh = section_temps_pool().acquire();
+        if (buf_ && keep) fresh->v = buf_->v;
+        buf_ = std::move(fresh);
+        shared_ = false;
+        return buf_->v.data();
+    }
+    void assign(temp_t T)                      { std::fill_n(writable(false), SECTION_N, T); }
+    void copy_from(const SectionTempBuffer& o) { std::memcpy(writable(false), o.data(), SECTION_N * sizeof(temp_t)); }
+    void clear()                               { buf_.reset(); shared_ = false; }
+
+    // The buffer as it is now, for a snapshot; this section will not write it again.
+    std::shared_ptr<const SectionTemps> share() { shared_ = true; return buf_; }
+    bool shared() const { return shared_; }
+
+private:
+    std::shared_ptr<SectionTemps> buf_;
+    bool shared_ = false;
+};
+
+// ====== Section (allocated only while it holds a non-void cell) ======
+// Dense: per-cell temperatures, masses and cached coefficients.
+// Uniform: one material, temperature and mass for all 4096 cells (fresh fill_section_with output).
+// A uniform section keeps no per-cell arrays, only the face conductances it owns toward its
+// +x/+y/+z neighbors, and is skipped by the compute pass while its neighbors hold the same
+// temperature. Reads go through T_row/T_at/mass_at/k*_plane, which cover both states.
+struct Section {
+    SectionPalette matIx;         // material index per cell (0=void recommended)
+
+    // Temperatures, stored as temp_t (see SIM_TEMP_STORAGE); read with temp_decode
+    SectionTempBuffer T_curr;   // K (front buffer)
+    SectionTempBuffer T_next;   // K (back buffer)
+
+    // mass map (kg per 1 m^3 cell)
     std::vector<float> mass_kg;
 
+    // -------- cached coefficients (derived from matIx/mass_kg, see rebuild_section_coeffs) --------
+    std::vector<float> kx, ky, kz;  // face conductance toward +x/+y/+z (border faces point into the neighbor)
+    std::vector<float> dtC;         // dt / thermal capacity per cell
+    std::unique_ptr<SectionHalo> halo;  // ghost layers (World::haloExchange), allocated on the first exchange
+
+    int nonVoid = 0;                // non-void cells; the section is released when this drops to 0
+
+    // -------- uniform state --------
+    bool dense = true;
+    alignas(64) std::array<temp_t, CHUNK_W> uniformRow{};  // uniform temperature, one row wide
+    float uniformMass = 0.0f;
+    std::vector<float> kxEdge, kyTop, kzEdge;  // owned boundary faces: x=15 [y][z], y=15 [z][x], z=15 [y][x]
+
+    size_t bytes() const {
+        return sizeof(Section) + matIx.bytes()
+             + (T_curr.size() + T_next.size()) * sizeof(temp_t)
+             + (mass_kg.capacity() + kx.capacity() + ky.capacity() + kz.capacity() + dtC.capacity()
+                + kxEdge.capacity() + kyTop.capacity() + kzEdge.capacity()) * sizeof(float)
+             + (halo ? sizeof(SectionHalo) : 0);
+    }
+
+    // X row starting at cell `base` (a cell_ix(0,y,z)).
+    const temp_t* T_row(int base) const { return dense ? T_curr.data() + base : uniformRow.data(); }
+    temp_t T_at(int i)      const { return dense ? T_curr[i] : uniformRow[0]; }
+    float  mass_at(int i)   const { return dense ? mass_kg[i] : uniformMass; }
+    // Faces this section owns toward its +y / +z / +x neighbor section, as X rows or one cell.
+    const float* ky_top_row(int z) const   { return dense ? ky.data() + cell_ix(0,SECTION_EDGE-1,z) : kyTop.data() + z*CHUNK_W; }
+    const float* kz_edge_row(int y) const  { return dense ? kz.data() + cell_ix(0,y,CHUNK_D-1) : kzEdge.data() + (y & (SECTION_EDGE-1))*CHUNK_W; }
+    float        kx_edge(int y, int z) const { return dense ? kx[cell_ix(CHUNK_W-1,y,z)] : kxEdge[(y & (SECTION_EDGE-1))*CHUNK_D + z]; }
+
+    // Turns the section into a uniform one (per-cell arrays released).
+    void make_uniform(uint16_t mat, temp_t T, float mass) {
+        matIx.fill(mat);
+        uniformRow.fill(T);
+        uniformMass = mass;
+        nonVoid = SECTION_N;
+        dense = false;
+        T_curr.clear();
+        T_next.clear();
+        for (auto* v : {&mass_kg, &kx, &ky, &kz, &dtC}) { v->clear(); v->shrink_to_fit(); }
+        halo.reset();
+        kxEdge.assign(SECTION_EDGE*CHUNK_D, 0.0f);
+        kyTop.assign(CHUNK_D*CHUNK_W, 0.0f);
+        kzEdge.assign(SECTION_EDGE*CHUNK_W, 0.0f);
+    }
+    // Expands a uniform section to per-cell arrays; coefficients must be rebuilt afterwards.
+    void make_dense() {
+        if (dense) return;
+        T_curr.assign(uniformRow[0]);
+        T_next.assign(uniformRow[0]);
+        mass_kg.assign(SECTION_N, uniformMass);
+        for (auto* v : {&kx, &ky, &kz, &dtC}) v->assign(SECTION_N, 0.0f);
+        for (auto* v : {&kxEdge, &kyTop, &kzEdge}) { v->clear(); v->shrink_to_fit(); }
+        dense = true;
+    }
+    // In-place frames (World::inPlace) run without T_next; see sync_back_buffers.
+    void release_back_buffer() { T_next.clear(); }
+    void ensure_back_buffer()  { if (dense && T_next.empty()) T_next.copy_from(T_curr); }
+
+    // Dense all-void section, or (dense=false) an empty shell for make_uniform.
+    explicit Section(uint16_t void_ix, bool dense_ = true)
+        : matIx(void_ix)
+        , mass_kg(dense_ ? SECTION_N : 0, 0.0f)
+        , kx(dense_ ? SECTION_N : 0, 0.0f)
+        , ky(dense_ ? SECTION_N : 0, 0.0f)
+        , kz(dense_ ? SECTION_N : 0, 0.0f)
+        , dtC(dense_ ? SECTION_N : 0, 0.0f)
+        , dense(dense_)
+    {
+        if (dense_) { T_curr.assign(temp_t{}); T_next.assign(temp_t{}); }
+    }
+};
+// Size of a section with unpacked uint16_t material indices (for comparison with Section::bytes()).
+constexpr size_t SECTION_BYTES = sizeof(Section) + SECTION_N * (sizeof(uint16_t) + 2 * sizeof(temp_t) + 5 * sizeof(float));
+
+// ====== Chunk ======
+struct Chunk {
+    // Air sections are nullptr and cost nothing; they read as void at 0 K.
+    std::array<std::unique_ptr<Section>, SECTIONS_Y> sections;
+
+    float coeff_dt = 0.0f;                              // dt the dtC arrays were built for
+    std::array<uint8_t, SECTIONS_Y> coeffDirty{};       // 1 = section (or its occupancy) changed since last rebuild
+
     uint16_t void_ix = 0;
     int cx = 0;
     int cz = 0;
@@ -63,66 +442,384 @@ struct Chunk {
     std::array<double, SECTIONS_Y> section_ms_last{};   // ms per section (last frame)
 
     // -------- which sections are "loaded"/exist --------
-    std::array<uint8_t, SECTIONS_Y> sectionLoaded{};    // 1 = has any non-void voxel
+    std::array<uint8_t, SECTIONS_Y> sectionLoaded{};    // 1 = allocated, i.e. has any non-void voxel
 
-    Chunk()
-        : T_curr(CHUNK_N, 0.0f)
-        , T_next(CHUNK_N, 0.0f)
-        , mass_kg(CHUNK_N, 0.0f)
-    {
+    // -------- activity (sleep/wake, see update_section_sleep) --------
+    std::array<float,    SECTIONS_Y> maxDelta{};        // max |dT| of the last frame the section ran (kernel result)
+    std::array<uint16_t, SECTIONS_Y> calmFrames{};      // consecutive run frames with maxDelta <= epsilon
+    std::array<uint8_t,  SECTIONS_Y> asleep{};          // 1 = skipped by compute until woken
+    std::array<uint8_t,  SECTIONS_Y> ranLast{};         // 1 = computed in the current/last frame (swap it)
+    std::array<uint8_t,  SECTIONS_Y> substeps{};        // multi-rate substeps per frame (0 = recompute)
+    int solveBase = 0;                                  // implicit solve: slot of the first loaded section
+    int multirateBase = 0;                              // multi-rate task list: task of sy = 0
+
+    // -------- horizontal neighbors (linked by World::ensureChunk / removeChunk; nullptr = not loaded) --------
+    Chunk* xn = nullptr;                                // (cx-1, cz)
+    Chunk* xp = nullptr;                                // (cx+1, cz)
+    Chunk* zn = nullptr;                                // (cx, cz-1)
+    Chunk* zp = nullptr;                                // (cx, cz+1)
+
+    Chunk() {
         section_ms_last.fill(0.0);
         sectionLoaded.fill(0);
+        coeffDirty.fill(1);
+    }
+
+    Section*       section(int sy)       { return sections[sy].get(); }
+    const Section* section(int sy) const { return sections[sy].get(); }
+
+    uint16_t matAt(int x, int y, int z) const {
+        const Section* S = section(y / SECTION_EDGE);
+        return S ? S->matIx.get(cell_ix(x,y,z)) : void_ix;
+    }
+    float TAt(int x, int y, int z) const {
+        const Section* S = section(y / SECTION_EDGE);
+        return S ? temp_decode(S->T_at(cell_ix(x,y,z))) : 0.0f;
     }
 };
 
 // ====== World ======
 struct ChunkCoord { int cx, cz; bool operator==(const ChunkCoord& o) const { return cx==o.cx && cz==o.cz; } };
-struct CoordHasher { size_t operator()(const ChunkCoord& k) const noexcept { return (std::hash<int>()(k.cx) << 1) ^ std::hash<int>()(k.cz); } };
+
+// A dense section falls asleep after `frames` consecutive frames with max |dT| <= epsilon and wakes
+// when a neighbor section (across chunk borders too) changed by more than epsilon or was edited.
+// epsilon = 0 only sleeps sections that are exactly unchanged, which keeps results bitwise
+// identical to simulating everything; epsilon < 0 disables sleeping.
+struct SleepConfig {
+    float epsilon = 0.0f;  // K per frame
+    int   frames  = 8;
+};
+
+// Explicit: forward-Euler Jacobi step per section (stable only while dtC * sum(k) <= 1).
+// ImplicitPCG: backward-Euler step over all loaded sections, solved with Jacobi-preconditioned
+// conjugate gradients; unconditionally stable, so dt can be tens of seconds.
+// MultiRate: explicit, but each section takes the power-of-two number of substeps its own
+// materials need (see section_substeps), so one stiff section no longer limits dt everywhere.
+enum class SimSolver : uint8_t { Explicit, ImplicitPCG, MultiRate };
+inline const char* sim_solver_name(SimSolver s) {
+    switch (s) {
+        case SimSolver::ImplicitPCG: return "implicit-pcg";
+        case SimSolver::MultiRate:   return "multi-rate";
+        default:                     return "explicit";
+    }
+}
+
+struct ImplicitConfig {
+    float tolerance = 1e-5f;  // stop when the preconditioned residual norm fell by this factor
+    int   maxIters  = 200;
+};
+struct ImplicitStats {
+    int    iterations = 0;    // CG iterations of the last implicit frame
+    float  residual   = 0.0f; // final relative preconditioned residual norm
+    size_t cells      = 0;    // unknowns (non-void cells)
+};
+// Buffers of implicit_solve_to_backbuffers, kept across frames and only grown.
+struct ImplicitSection;
+struct ImplicitWorkspace {
+    std::vector<ImplicitSection> secs;        // loaded sections, numbered chunk by chunk
+    std::vector<float> x, r, z, p, q, minv;   // SECTION_N floats per section
+    std::vector<double> part;                 // per-section partial dot products
+};
+
+struct MultiRateConfig {
+    int maxSubsteps = 64;     // power of two, <= 128; stiffer sections are clamped as in Explicit
+};
+struct MultiRateStats {
+    int    maxSubsteps  = 1;  // largest section substep count of the last frame
+    size_t sectionSteps = 0;  // section substeps run in the last frame
+};
+// Task list of multirate_frame_to_backbuffers, kept across frames. Rebuilt when the chunk set
+// (World::chunkEpoch) or any section's rate changes, otherwise reused as is.
+struct MultiRateSection;
+struct MultiRateWorkspace {
+    std::vector<MultiRateSection> secs;        // SECTIONS_Y tasks per chunk, from Chunk::multirateBase
+    std::array<std::vector<int>, 8> byRate;    // tasks of rate 1 << k (MULTIRATE_MAX_SUBSTEPS = 128)
+    std::vector<float> regs;                   // registers of faces toward finer neighbors; 0 between frames
+    std::vector<std::pair<Chunk*, int>> stale; // sections whose substep count is being recomputed
+    uint64_t chunkEpoch = ~0ull;
+};
+
+// Wall time of the stages of the last compute_frame_to_backbuffers call. The implicit and
+// multi-rate solvers report their solve as kernelMs.
+struct FramePhaseTimes {
+    double prepareMs = 0.0;   // promote, back buffers, sleep, coefficient refresh, task list
+    double haloMs    = 0.0;   // halo exchange pass (World::haloExchange only)
+    double kernelMs  = 0.0;   // section kernel passes
+};
+
+// ====== Chunk index (32x32-chunk region tiles in a flat open-addressing table) ======
+// Regions are found by linear probing on their coordinate and hold their chunks in a dense
+// [z][x] array, so a lookup is one probe sequence plus one array index. Iteration visits regions
+// in (rz, rx) order and chunks row by row inside, i.e. neighbors in x are neighbors in the loop.
+// Regions are kept once created (an empty one costs 8 KiB and is skipped by iteration).
+// Items expose .first (coordinate) and .second (Chunk*), like the map this replaced.
+constexpr int REGION_SHIFT = 5;
+constexpr int REGION_EDGE  = 1 << REGION_SHIFT;      // chunks per region side
+constexpr int REGION_N     = REGION_EDGE * REGION_EDGE;
+
+class ChunkIndex {
+public:
+    struct Item { ChunkCoord first; Chunk* second; };
+
+    class iterator {
+    public:
+        iterator(const ChunkIndex* ix, size_t r) : ix_(ix), r_(r) { settle(); }
+        Item& operator*()  { return cur_; }
+        Item* operator->() { return &cur_; }
+        iterator& operator++() { ++c_; settle(); return *this; }
+        bool operator!=(const iterator& o) const { return r_ != o.r_ || c_ != o.c_; }
+        bool operator==(const iterator& o) const { return !(*this != o); }
+    private:
+        void settle() {
+            for (; r_ < ix_->order_.size(); ++r_, c_ = 0) {
+                const Region& R = *ix_->order_[r_];
+                if (R.count == 0) continue;
+                for (; c_ < REGION_N; ++c_)
+                    if (Chunk* C = R.cells[c_].get()) { cur_ = Item{ChunkCoord{C->cx, C->cz}, C}; return; }
+            }
+        }
+        const ChunkIndex* ix_;
+        size_t r_;
+        int c_ = 0;
+        Item cur_{};
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end()   const { return iterator(this, order_.size()); }
+    size_t size()  const { return count_; }
+    bool   empty() const { return count_ == 0; }
+
+    Chunk* find(int cx, int cz) const {
+        const Region* R = region(cx >> REGION_SHIFT, cz >> REGION_SHIFT);
+        return R ? R->cells[cell(cx, cz)].get() : nullptr;
+    }
+    // Takes ownership; the slot must be empty.
+    Chunk* insert(std::unique_ptr<Chunk> C) {
+        Region& R = region_or_add(C->cx >> REGION_SHIFT, C->cz >> REGION_SHIFT);
+        auto& slot = R.cells[cell(C->cx, C->cz)];
+        slot = std::move(C);
+        ++R.count; ++count_;
+        return slot.get();
+    }
+    void erase(int cx, int cz) {
+        Region* R = region(cx >> REGION_SHIFT, cz >> REGION_SHIFT);
+        if (!R || !R->cells[cell(cx, cz)]) return;
+        R->cells[cell(cx, cz)].reset();
+        --R->count; --count_;
+    }
+
+    // f(cx, cz, Chunk* or nullptr) for every coordinate of [cx0, cx1] x [cz0, cz1], z rows then x;
+    // one table probe per row segment inside a region.
+    template<class F> void for_each_in_range(int cx0, int cz0, int cx1, int cz1, F&& f) const {
+        for (int cz = cz0; cz <= cz1; ++cz)
+            for (int cx = cx0; cx <= cx1; ) {
+                const Region* R = region(cx >> REGION_SHIFT, cz >> REGION_SHIFT);
+                const int last = std::min(cx1, (cx | (REGION_EDGE - 1)));
+                for (; cx <= last; ++cx) f(cx, cz, R ? R->cells[cell(cx, cz)].get() : nullptr);
+            }
+    }
+    // Bounding box of the loaded chunks; false when there are none.
+    bool bounds(int& minCX, int& minCZ, int& maxCX, int& maxCZ) const {
+        bool any = false;
+        for (const Region* R : order_) {
+            if (R->count == 0) continue;
+            for (int c=0; c<REGION_N; ++c) {
+                const Chunk* C = R->cells[c].get();
+                if (!C) continue;
+                if (!any) { minCX = maxCX = C->cx; minCZ = maxCZ = C->cz; any = true; continue; }
+                minCX = std::min(minCX, C->cx); maxCX = std::max(maxCX, C->cx);
+                minCZ = std::min(minCZ, C->cz); maxCZ = std::max(maxCZ, C->cz);
+            }
+        }
+        return any;
+    }
+
+private:
+    struct Region {
+        int rx, rz;
+        int count = 0;
+        std::array<std::unique_ptr<Chunk>, REGION_N> cells;   // [lz][lx]
+    };
+    struct Slot { int rx = 0, rz = 0; Region* R = nullptr; };
+
+    static int cell(int cx, int cz) { return (cz & (REGION_EDGE - 1)) * REGION_EDGE + (cx & (REGION_EDGE - 1)); }
+    size_t home(int rx, int rz) const {
+        uint64_t k = (uint64_t(uint32_t(rx)) << 32) | uint32_t(rz);
+        k *= 0x9E3779B97F4A7C15ull;
+        return size_t(k >> 32) & (slots_.size() - 1);
+    }
+    Region* region(int rx, int rz) const {
+        if (slots_.empty()) return nullptr;
+        for (size_t i = home(rx, rz); ; i = (i + 1) & (slots_.size() - 1)) {
+            const Slot& s = slots_[i];
+            if (!s.R) return nullptr;
+            if (s.rx == rx && s.rz == rz) return s.R;
+        }
+    }
+    Region& region_or_add(int rx, int rz) {
+        if (Region* R = region(rx, rz)) return *R;
+        if ((regions_.size() + 1) * 2 > slots_.size()) rehash(std::max<size_t>(16, slots_.size() * 2));
+        regions_.push_back(std::make_unique<Region>());
+        Region* R = regions_.back().get();
+        R->rx = rx; R->rz = rz;
+        place(R);
+        auto at = std::lower_bound(order_.begin(), order_.end(), R, [](const Region* a, const Region* b) {
+            return a->rz != b->rz ? a->rz < b->rz : a->rx < b->rx;
+        });
+        order_.insert(at, R);
+        return *R;
+    }
+    void place(Region* R) {
+        size_t i = home(R->rx, R->rz);
+        while (slots_[i].R) i = (i + 1) & (slots_.size() - 1);
+        slots_[i] = Slot{R->rx, R->rz, R};
+    }
+    void rehash(size_t n) {
+        slots_.assign(n, Slot{});
+        for (auto& R : regions_) place(R.get());
+    }
+
+    std::vector<Slot> slots_;                       // power-of-two size, at most half full
+    std::vector<std::unique_ptr<Region>> regions_;  // owners, creation order
+    std::vector<Region*> order_;                    // by (rz, rx)
+    size_t count_ = 0;
+};
 
 struct World {
-    std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, CoordHasher> chunks;
+    ChunkIndex chunks;
     MaterialLUT materials;
+    SleepConfig sleep;
+    SimSolver solver = SimSolver::Explicit;
+    bool inPlace = false;     // Explicit only: Jacobi frames through a per-worker scratch, no T_next
+    bool haloExchange = false; // Explicit only: copy the x/z borders into SectionHalo in a pass before
+                               // the kernels, which then touch no other chunk (sharding); costs a pass
+    ImplicitConfig implicit;
+    ImplicitStats implicitLast;
+    ImplicitWorkspace implicitWork;
+    MultiRateConfig multirate;
+    MultiRateStats multirateLast;
+    MultiRateWorkspace multirateWork;
+    FramePhaseTimes phaseLast;
+    std::vector<temp_t> shellScratch;   // in-place frames: parked section shells, grown on demand
+    uint64_t chunkEpoch = 0;            // bumped whenever a chunk is added or removed
 
     Chunk* ensureChunk(int cx, int cz) {
-        ChunkCoord key{cx,cz};
-        auto it = chunks.find(key);
-        if (it != chunks.end()) return it->second.get();
+        if (Chunk* C = chunks.find(cx, cz)) return C;
         auto ptr = std::make_unique<Chunk>();
         ptr->cx = cx; ptr->cz = cz;
-        Chunk* raw = ptr.get();
-        chunks.emplace(key, std::move(ptr));
+        Chunk* raw = chunks.insert(std::move(ptr));
+        ++chunkEpoch;
+        if ((raw->xn = findChunk(cx - 1, cz))) raw->xn->xp = raw;
+        if ((raw->xp = findChunk(cx + 1, cz))) raw->xp->xn = raw;
+        if ((raw->zn = findChunk(cx, cz - 1))) raw->zn->zp = raw;
+        if ((raw->zp = findChunk(cx, cz + 1))) raw->zp->zn = raw;
         return raw;
     }
-    Chunk* findChunk(int cx, int cz) const {
-        auto it = chunks.find(ChunkCoord{cx,cz});
-        return (it==chunks.end()) ? nullptr : it->second.get();
+    // Unlinks and frees the chunk. Its neighbors rebuild their coefficients (faces toward it
+    // become k = 0); pointers to it or its sections are invalid afterwards.
+    void removeChunk(int cx, int cz) {
+        Chunk* found = chunks.find(cx, cz);
+        if (!found) return;
+        Chunk& C = *found;
+        if (C.xn) { C.xn->xp = nullptr; C.xn->coeffDirty.fill(1); }
+        if (C.xp) { C.xp->xn = nullptr; C.xp->coeffDirty.fill(1); }
+        if (C.zn) { C.zn->zp = nullptr; C.zn->coeffDirty.fill(1); }
+        if (C.zp) { C.zp->zn = nullptr; C.zp->coeffDirty.fill(1); }
+        chunks.erase(cx, cz);
+        ++chunkEpoch;
     }
+    Chunk* findChunk(int cx, int cz) const { return chunks.find(cx, cz); }
 };
 
+// Chunk at (C.cx + dcx, C.cz + dcz) with |dcx|, |dcz| <= 1, through the neighbor links; only a
+// diagonal whose two side neighbors are both missing is looked up in the map.
+inline const Chunk* neighbor_chunk(const World& world, const Chunk& C, int dcx, int dcz) {
+    const Chunk* X = dcx < 0 ? C.xn : dcx > 0 ? C.xp : &C;
+    const Chunk* Z = dcz < 0 ? C.zn : dcz > 0 ? C.zp : &C;
+    if (dcz == 0) return X;
+    if (dcx == 0) return Z;
+    if (X) return dcz < 0 ? X->zn : X->zp;
+    if (Z) return dcx < 0 ? Z->xn : Z->xp;
+    return world.findChunk(C.cx + dcx, C.cz + dcz);
+}
+
+// ====== Section allocation; sectionLoaded mirrors which sections exist ======
+// Changing occupancy marks the section dirty so the faces neighbors own toward it get rebuilt.
+inline Section& allocSection(Chunk& C, int sy, bool dense = true) {
+    if (!C.sections[sy]) {
+        C.sections[sy] = std::make_unique<Section>(C.void_ix, dense);
+        C.sectionLoaded[sy] = 1;
+        C.coeffDirty[sy] = 1;
+        C.maxDelta[sy] = 0.0f; C.calmFrames[sy] = 0; C.asleep[sy] = 0; C.ranLast[sy] = 0;
+    }
+    return *C.sections[sy];
+}
+inline void releaseSection(Chunk& C, int sy) {
+    if (!C.sections[sy]) return;
+    C.sections[sy].reset();
+    C.sectionLoaded[sy] = 0;
+    C.coeffDirty[sy] = 1;
+    C.asleep[sy] = 0; C.ranLast[sy] = 0;
+}
+
 // ====== Helpers to mark which sections exist (non-void) ======
+// Recounts non-void cells of every allocated section, compacts its palette and releases the empty ones.
+// A dense section whose cells all share one material, temperature and mass goes back to uniform.
 inline void recomputeSectionLoaded(Chunk& C) {
-    C.sectionLoaded.fill(0);
     for (int sy=0; sy<SECTIONS_Y; ++sy) {
-        const int y0 = sy * SECTION_EDGE;
-        const int y1 = y0 + SECTION_EDGE;
-        bool any = false;
-        for (int z=0; z<CHUNK_D && !any; ++z) {
-            for (int y=y0; y<y1 && !any; ++y) {
-                for (int x=0; x<CHUNK_W; ++x) {
-                    if (C.matIx[idx(x,y,z)] != C.void_ix) { any = true; break; }
-                }
-            }
+        Section* S = C.section(sy);
+        if (!S) continue;
+        S->nonVoid = S->matIx.compact(C.void_ix);
+        if (S->nonVoid == 0) { releaseSection(C, sy); continue; }
+        if (S->dense && S->matIx.uniform()
+            && std::all_of(S->T_curr.data(), S->T_curr.data() + SECTION_N, [&](temp_t t){ return std::memcmp(&t, S->T_curr.data(), sizeof(t)) == 0; })
+            && std::all_of(S->mass_kg.begin(), S->mass_kg.end(), [&](float m){ return m == S->mass_kg[0]; })) {
+            S->make_uniform(S->matIx.get(0), S->T_curr[0], S->mass_kg[0]);
+            C.coeffDirty[sy] = 1;
         }
-        C.sectionLoaded[sy] = any ? 1 : 0;
     }
 }
+// loaded=true allocates an all-void section (for callers that then write cells); false drops it.
 inline void markSectionLoaded(Chunk& C, int sy, bool loaded) {
-    if (sy >= 0 && sy < SECTIONS_Y) C.sectionLoaded[sy] = loaded ? 1 : 0;
+    if (sy < 0 || sy >= SECTIONS_Y) return;
+    if (loaded) allocSection(C, sy);
+    else        releaseSection(C, sy);
+}
+// Call after writing matIx or mass_kg directly; coefficients are rebuilt before the next compute.
+inline void markSectionCoeffsDirty(Chunk& C, int sy) {
+    if (sy >= 0 && sy < SECTIONS_Y) C.coeffDirty[sy] = 1;
 }
 inline void recomputeAllSectionLoaded(World& world) {
     for (auto& kv : world.chunks) recomputeSectionLoaded(*kv.second);
 }
 
+// Bytes held by allocated sections.
+inline size_t chunk_storage_bytes(const Chunk& C) {
+    size_t n = 0;
+    for (int sy=0; sy<SECTIONS_Y; ++sy) n += C.section(sy) ? C.section(sy)->bytes() : 0;
+    return n;
+}
+inline size_t world_storage_bytes(const World& world) {
+    size_t n = 0;
+    for (const auto& kv : world.chunks) n += sizeof(Chunk) + chunk_storage_bytes(*kv.second);
+    return n;
+}
+// Frames that advance T_curr directly and keep no T_next: Explicit with inPlace.
+inline bool world_in_place(const World& world) {
+    return world.solver == SimSolver::Explicit && world.inPlace;
+}
+// Drops T_next of every dense section for in-place frames and restores it (as a copy of T_curr)
+// otherwise, so switching solvers at runtime is safe.
+inline void sync_back_buffers(World& world) {
+    const bool inPlace = world_in_place(world);
+    for (auto& kv : world.chunks)
+        for (auto& S : kv.second->sections) {
+            if (!S || !S->dense)  continue;
+            if (inPlace)          S->release_back_buffer();
+            else                  S->ensure_back_buffer();
+        }
+}
+
 // ====== Neighbor sampling across chunk borders ======
 struct NeighborSample {
     float     T;         // neighbor temperature
@@ -144,123 +841,1834 @@ inline NeighborSample sample_neighbor_T(const World& world, const Chunk& C, int
     if (nz < 0)           { ncz = C.cz - 1; lz = CHUNK_D - 1; }
     else if (nz >= CHUNK_D){ ncz = C.cz + 1; lz = 0; }
 
-    const Chunk* CC = &C;
-    if (ncx != C.cx || ncz != C.cz) {
-        CC = world.findChunk(ncx, ncz);
-        if (!CC) return NeighborSample{0.0f, C.void_ix, false};
+    const Chunk* CC = neighbor_chunk(world, C, ncx - C.cx, ncz - C.cz);
+    if (!CC) return NeighborSample{0.0f, C.void_ix, false};
+
+    return NeighborSample{ CC->TAt(lx, ny, lz), CC->matAt(lx, ny, lz), true };
+}
+
+// ====== Per-section neighborhood (resolved once, not per sample) ======
+// nullptr = outside the world, chunk not loaded, or air section.
+// With `halo` set, the x/z neighbors are read from the ghost layers and xn..zp are unused.
+struct SectionNeighbors {
+    const Section* xn = nullptr;  // same sy in chunk (cx-1, cz)
+    const Section* xp = nullptr;  // same sy in chunk (cx+1, cz)
+    const Section* zn = nullptr;  // same sy in chunk (cx, cz-1)
+    const Section* zp = nullptr;  // same sy in chunk (cx, cz+1)
+    const Section* yn = nullptr;  // sy-1 in this chunk
+    const Section* yp = nullptr;  // sy+1 in this chunk
+    const SectionHalo* halo = nullptr;
+};
+inline SectionNeighbors resolve_section_neighbors(const World&, const Chunk& C, int sy) {
+    auto at = [&](const Chunk* N) -> const Section* { return N ? N->section(sy) : nullptr; };
+    SectionNeighbors nb;
+    nb.xn = at(C.xn);
+    nb.xp = at(C.xp);
+    nb.zn = at(C.zn);
+    nb.zp = at(C.zp);
+    nb.yn = (sy > 0)            ? C.section(sy - 1) : nullptr;
+    nb.yp = (sy + 1 < SECTIONS_Y) ? C.section(sy + 1) : nullptr;
+    return nb;
+}
+// Neighborhood of the section kernels: sy-1 / sy+1 of this chunk; x/z from the halo when the
+// section has one (World::haloExchange), else straight from the linked neighbor chunks.
+inline SectionNeighbors kernel_section_neighbors(const Chunk& C, int sy) {
+    SectionNeighbors nb;
+    nb.yn = (sy > 0)            ? C.section(sy - 1) : nullptr;
+    nb.yp = (sy + 1 < SECTIONS_Y) ? C.section(sy + 1) : nullptr;
+    if ((nb.halo = C.section(sy)->halo.get())) return nb;
+    auto at = [&](const Chunk* N) -> const Section* { return N ? N->section(sy) : nullptr; };
+    nb.xn = at(C.xn);
+    nb.xp = at(C.xp);
+    nb.zn = at(C.zn);
+    nb.zp = at(C.zp);
+    return nb;
+}
+
+// Harmonic-mean face conductance; 0 if either side does not conduct.
+// Symmetric bitwise (2*k is exact), so a face can be evaluated from either side.
+inline float k_harmonic(float k1, float k2) {
+    return (k1 <= 0.0f || k2 <= 0.0f) ? 0.0f : 2.0f * k1 * k2 / (k1 + k2);
+}
+
+// ====== Cached coefficients ======
+// Each face is owned by its minus-side cell (kx/ky/kz point toward +x/+y/+z), so a material,
+// mass or occupancy change in a section touches its own faces plus the adjacent minus-side
+// planes: the top plane of sy-1, x=CHUNK_W-1 in the -x chunk and z=CHUNK_D-1 in the -z chunk.
+// Faces toward an air section / missing chunk / the world top are 0.
+// Uniform sections only store their boundary faces (kxEdge/kyTop/kzEdge); interior faces and dtC
+// are not needed until the section is made dense.
+inline void update_cell_coeffs(Section& S, const SectionNeighbors& nb, const MaterialLUT& mats,
+                               int x, int y, int z, float dt_seconds)
+{
+    const int i = cell_ix(x,y,z);
+    const Material& m = mats.byIx(S.matIx.get(i));
+    const float k1 = m.thermalConductivity;
+    auto kOf = [&](const Section* SS, int j) { return SS ? k_harmonic(k1, mats.byIx(SS->matIx.get(j)).thermalConductivity) : 0.0f; };
+
+    if (!S.dense) {
+        const int yl = y & (SECTION_EDGE-1);
+        if (x == CHUNK_W-1)      S.kxEdge[yl*CHUNK_D + z] = kOf(nb.xp, cell_ix(0,y,z));
+        if (yl == SECTION_EDGE-1) S.kyTop[z*CHUNK_W + x]  = kOf(nb.yp, cell_ix(x,y+1,z));
+        if (z == CHUNK_D-1)      S.kzEdge[yl*CHUNK_W + x] = kOf(nb.zp, cell_ix(x,y,0));
+        return;
+    }
+    S.dtC[i] = dt_seconds / std::max(1e-8f, S.mass_kg[i] * m.heatCapacity);
+    S.kx[i]  = (x + 1 < CHUNK_W) ? kOf(&S, cell_ix(x+1,y,z)) : kOf(nb.xp, cell_ix(0,y,z));
+    S.ky[i]  = ((y + 1) % SECTION_EDGE) ? kOf(&S, cell_ix(x,y+1,z)) : kOf(nb.yp, cell_ix(x,y+1,z));
+    S.kz[i]  = (z + 1 < CHUNK_D) ? kOf(&S, cell_ix(x,y,z+1)) : kOf(nb.zp, cell_ix(x,y,0));
+}
+
+inline void rebuild_section_coeffs(World& world, Chunk& C, int sy, float dt_seconds) {
+    const MaterialLUT& mats = world.materials;
+    const int y0 = sy * SECTION_EDGE;
+
+    if (Section* S = C.section(sy)) {
+        const SectionNeighbors nb = resolve_section_neighbors(world, C, sy);
+        if (S->dense) {
+            for_each_section_row(sy, [&](int y, int z) {
+                for (int x=0; x<CHUNK_W; ++x) update_cell_coeffs(*S, nb, mats, x, y, z, dt_seconds);
+            });
+        } else {
+            for (int y=y0; y<y0+SECTION_EDGE; ++y)
+                for (int z=0; z<CHUNK_D; ++z) update_cell_coeffs(*S, nb, mats, CHUNK_W-1, y, z, dt_seconds);
+            for (int z=0; z<CHUNK_D; ++z)
+                for (int x=0; x<CHUNK_W; ++x) update_cell_coeffs(*S, nb, mats, x, y0+SECTION_EDGE-1, z, dt_seconds);
+            for (int y=y0; y<y0+SECTION_EDGE; ++y)
+                for (int x=0; x<CHUNK_W; ++x) update_cell_coeffs(*S, nb, mats, x, y, CHUNK_D-1, dt_seconds);
+        }
+    }
+
+    if (Section* B = (sy > 0) ? C.section(sy - 1) : nullptr) {
+        const SectionNeighbors bnb = resolve_section_neighbors(world, C, sy - 1);
+        for (int z=0; z<CHUNK_D; ++z)
+            for (int x=0; x<CHUNK_W; ++x) update_cell_coeffs(*B, bnb, mats, x, y0-1, z, C.coeff_dt);
+    }
+    if (Chunk* W = C.xn) {
+        if (Section* WS = W->section(sy)) {
+            const SectionNeighbors wnb = resolve_section_neighbors(world, *W, sy);
+            for_each_section_row(sy, [&](int y, int z) { update_cell_coeffs(*WS, wnb, mats, CHUNK_W-1, y, z, W->coeff_dt); });
+        }
+    }
+    if (Chunk* N = C.zn) {
+        if (Section* NS = N->section(sy)) {
+            const SectionNeighbors nnb = resolve_section_neighbors(world, *N, sy);
+            for (int y=y0; y<y0+SECTION_EDGE; ++y)
+                for (int x=0; x<CHUNK_W; ++x) update_cell_coeffs(*NS, nnb, mats, x, y, CHUNK_D-1, N->coeff_dt);
+        }
+    }
+    // The substep counts of this section and its six neighbors depend on the faces just rebuilt.
+    C.substeps[sy] = 0;
+    if (sy > 0)              C.substeps[sy-1] = 0;
+    if (sy + 1 < SECTIONS_Y) C.substeps[sy+1] = 0;
+    for (Chunk* N : {C.xn, C.xp, C.zn, C.zp})
+        if (N) N->substeps[sy] = 0;
+    C.coeffDirty[sy] = 0;
+}
+
+// Rebuild every dirty section (or all of them when dt changed). Run before the compute pass.
+inline void refresh_dirty_coeffs(World& world, float dt_seconds) {
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        if (C.coeff_dt != dt_seconds) { C.coeffDirty.fill(1); C.coeff_dt = dt_seconds; }
+        for (int sy=0; sy<SECTIONS_Y; ++sy)
+            if (C.coeffDirty[sy]) rebuild_section_coeffs(world, C, sy, dt_seconds);
+    }
+}
+
+// ====== Row neighborhood ======
+// Every pointer is valid: a missing neighbor row (outside the world, unloaded chunk, air section)
+// points at ZERO_ROW / ZERO_TROW. Its face conductance is 0, so it contributes an exact zero, same as skipping it.
+alignas(64) inline constexpr float  ZERO_ROW[CHUNK_W]  = {};
+alignas(64) inline constexpr temp_t ZERO_TROW[CHUNK_W] = {};  // encodes 0 K in every storage mode
+
+struct SectionRowNeighbors {
+    const temp_t* Typ; const float* Kyp;  // row at y+1, face y|y+1
+    const temp_t* Tym; const float* Kym;  // row at y-1, face y-1|y
+    const temp_t* Tzp; const float* Kzp;  // row at z+1, face z|z+1
+    const temp_t* Tzm; const float* Kzm;  // row at z-1, face z-1|z
+    float Txp = 0.0f;                    // cell at x=CHUNK_W (its face is kx[x=CHUNK_W-1])
+    float Txn = 0.0f, Kxn = 0.0f;        // cell at x=-1 and face -1|0
+};
+inline SectionRowNeighbors section_row_neighbors(const Section& S, const SectionNeighbors& nb, int y, int z) {
+    SectionRowNeighbors r;
+    const int base = cell_ix(0,y,z);
+    const int yl   = y % SECTION_EDGE;
+
+    // S is dense; neighbor sections may be uniform, so they are read through the Section accessors.
+    r.Kyp = S.ky.data() + base;
+    if (yl + 1 < SECTION_EDGE) r.Typ = S.T_curr.data() + base + CELL_SY;
+    else                       r.Typ = nb.yp ? nb.yp->T_row(cell_ix(0,y+1,z)) : ZERO_TROW;
+    if (yl > 0)     { r.Tym = S.T_curr.data() + base - CELL_SY; r.Kym = S.ky.data() + base - CELL_SY; }
+    else if (nb.yn) { r.Tym = nb.yn->T_row(cell_ix(0,y-1,z)); r.Kym = nb.yn->ky_top_row(z); }
+    else            { r.Tym = ZERO_TROW; r.Kym = ZERO_ROW; }
+
+    r.Kzp = S.kz.data() + base;
+    if (z + 1 < CHUNK_D) r.Tzp = S.T_curr.data() + base + CELL_SZ;
+    else if (nb.halo)    r.Tzp = nb.halo->zp.data() + SectionHalo::row(y);
+    else                 r.Tzp = nb.zp ? nb.zp->T_row(cell_ix(0,y,0)) : ZERO_TROW;
+    if (z > 0)        { r.Tzm = S.T_curr.data() + base - CELL_SZ; r.Kzm = S.kz.data() + base - CELL_SZ; }
+    else if (nb.halo) { r.Tzm = nb.halo->zn.data() + SectionHalo::row(y); r.Kzm = nb.halo->kzn.data() + SectionHalo::row(y); }
+    else if (nb.zn)   { r.Tzm = nb.zn->T_row(cell_ix(0,y,CHUNK_D-1)); r.Kzm = nb.zn->kz_edge_row(y); }
+    else              { r.Tzm = ZERO_TROW; r.Kzm = ZERO_ROW; }
+
+    if (nb.halo) {
+        const int i = SectionHalo::col(y, z);
+        r.Txp = temp_decode(nb.halo->xp[i]);
+        r.Txn = temp_decode(nb.halo->xn[i]); r.Kxn = nb.halo->kxn[i];
+        return r;
     }
+    if (nb.xp) { r.Txp = temp_decode(nb.xp->T_at(cell_ix(0,y,z))); }
+    if (nb.xn) { r.Txn = temp_decode(nb.xn->T_at(cell_ix(CHUNK_W-1,y,z))); r.Kxn = nb.xn->kx_edge(y, z); }
+    return r;
+}
 
-    int i = idx(lx, ny, lz);
-    return NeighborSample{ CC->T_curr[i], CC->matIx[i], true };
+// ====== Halo exchange ======
+// Fills the ghost layers of one dense section from its x/z neighbor chunks. With
+// World::haloExchange it runs as its own phase before the kernel pass: it only writes this
+// section's halo and only reads the neighbors, which nothing writes meanwhile, and afterwards the
+// kernels touch no other chunk.
+inline void exchange_section_halo(const World& world, Chunk& C, int sy) {
+    Section& S = *C.section(sy);
+    if (!S.halo) S.halo = std::make_unique<SectionHalo>();
+    SectionHalo& h = *S.halo;
+    const SectionNeighbors nb = resolve_section_neighbors(world, C, sy);
+    for (int yl=0; yl<SECTION_EDGE; ++yl) {
+        const int r = SectionHalo::row(yl);
+        std::memcpy(h.zn.data()  + r, nb.zn ? nb.zn->T_row(cell_ix(0,yl,CHUNK_D-1)) : ZERO_TROW, CHUNK_W * sizeof(temp_t));
+        std::memcpy(h.zp.data()  + r, nb.zp ? nb.zp->T_row(cell_ix(0,yl,0))         : ZERO_TROW, CHUNK_W * sizeof(temp_t));
+        std::memcpy(h.kzn.data() + r, nb.zn ? nb.zn->kz_edge_row(yl)                 : ZERO_ROW,  CHUNK_W * sizeof(float));
+        const int c = SectionHalo::col(yl, 0);
+        for (int z=0; z<CHUNK_D; ++z) h.xp[c + z] = nb.xp ? nb.xp->T_row(cell_ix(0,yl,z))[0] : temp_t{};
+        if (!nb.xn) {
+            std::fill_n(h.xn.data() + c, CHUNK_D, temp_t{});
+            std::fill_n(h.kxn.data() + c, CHUNK_D, 0.0f);
+            continue;
+        }
+        for (int z=0; z<CHUNK_D; ++z) {
+            h.xn[c + z]  = nb.xn->T_row(cell_ix(0,yl,z))[CHUNK_W-1];
+            h.kxn[c + z] = nb.xn->kx_edge(yl, z);
+        }
+    }
 }
 
 // ====== SIMULATION CORE ======
-inline void simulate_section_16x16x16(World& world, Chunk& C, const MaterialLUT& mats, int sy, float dt_seconds) {
+// Steady state is pure loads and multiply-adds over the cached kx/ky/kz/dtC arrays (dx = 1 m).
+// Neighbor sections are resolved once per section and neighbor rows once per row, so the
+// per-cell stencil is direct-indexed; only x=0 / x=CHUNK_W-1 pick their x-neighbor from the row.
+// Accumulation order is +x,-x,+y,-y,+z,-z in every kernel variant.
+// Void cells keep their temperature; the material row is only decoded from the palette when
+// the section's palette contains void at all.
+// Writes `out` (SECTION_N cells, same layout as T_curr) and returns max |Tnew - Tc| over the
+// section (before storage encoding) for the sleep scheduler.
+// Requires refresh_dirty_coeffs() for this dt (and exchange_section_halo() if the section has a halo).
+inline float simulate_section_scalar(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    float maxDelta = 0.0f;
+
+    for_each_section_row(sy, [&](int y, int z) {
+        const SectionRowNeighbors r = section_row_neighbors(S, nb, y, z);
+        const int base = cell_ix(0,y,z);
+        uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+        const temp_t*   T   = S.T_curr.data() + base;
+        const float*    KX  = S.kx.data()     + base;
+        const float*    DTC = S.dtC.data()    + base;
+        temp_t*         Tn  = out + base;
+
+        for (int x=0; x<CHUNK_W; ++x) {
+            if (anyVoid && M[x] == C.void_ix) { Tn[x] = T[x]; continue; }
+
+            const float Tc  = temp_decode(T[x]);
+            const float Txp = (x + 1 < CHUNK_W) ? temp_decode(T[x+1]) : r.Txp;
+            const float Txn = (x > 0)           ? temp_decode(T[x-1]) : r.Txn;
+            const float Kxn = (x > 0)           ? KX[x-1] : r.Kxn;
+
+            float dT = 0.0f;
+            dT += KX[x]    * (Txp                   - Tc);
+            dT += Kxn      * (Txn                   - Tc);
+            dT += r.Kyp[x] * (temp_decode(r.Typ[x]) - Tc);
+            dT += r.Kym[x] * (temp_decode(r.Tym[x]) - Tc);
+            dT += r.Kzp[x] * (temp_decode(r.Tzp[x]) - Tc);
+            dT += r.Kzm[x] * (temp_decode(r.Tzm[x]) - Tc);
+
+            float Tnew = Tc + DTC[x] * dT;
+            if      (Tnew <   0.0f) Tnew = 0.0f;
+            else if (Tnew > 6000.0f) Tnew = 6000.0f;
+            Tn[x] = temp_encode(Tnew);
+            maxDelta = std::max(maxDelta, std::fabs(Tnew - Tc));
+        }
+    });
+    return maxDelta;
+}
+
+// ====== Flux-form kernels (each interior face evaluated once) ======
+// q = k * (T_plus - T_minus) per face; the minus cell adds q, the plus cell subtracts it. Since
+// k*(a-b) == -(k*(b-a)) and d - q == d + (-q) exactly, the result matches the cell kernels bit
+// for bit (same +x,-x,+y,-y,+z,-z order) with half the face multiplies and conductance loads.
+// A face is carried to its plus cell: x to the next lane, z to the next row, y to the next plane.
+// Faces on the section boundary are evaluated by both sections, as exact negatives of each other.
+struct SectionRowFlux {
+    const temp_t* Typ; const float* Kyp;                            // row at y+1, face y|y+1
+    const temp_t* Tzp; const float* Kzp;                            // row at z+1, face z|z+1
+    const temp_t* Tym = ZERO_TROW; const float* Kym = ZERO_ROW;     // row at y-1 (first plane only)
+    const temp_t* Tzm = ZERO_TROW; const float* Kzm = ZERO_ROW;     // row at z-1 (first row only)
+    float Txp = 0.0f;                    // cell at x=CHUNK_W (its face is kx[x=CHUNK_W-1])
+    float Txn = 0.0f, Kxn = 0.0f;        // cell at x=-1 and face -1|0
+};
+inline SectionRowFlux section_row_flux(const Section& S, const SectionNeighbors& nb, int y, int z) {
+    SectionRowFlux r;
+    const int base = cell_ix(0,y,z);
+    const int yl   = y & (SECTION_EDGE-1);
+
+    r.Kyp = S.ky.data() + base;
+    if (yl + 1 < SECTION_EDGE) r.Typ = S.T_curr.data() + base + CELL_SY;
+    else                       r.Typ = nb.yp ? nb.yp->T_row(cell_ix(0,y+1,z)) : ZERO_TROW;
+    if (yl == 0 && nb.yn) { r.Tym = nb.yn->T_row(cell_ix(0,y-1,z)); r.Kym = nb.yn->ky_top_row(z); }
+
+    r.Kzp = S.kz.data() + base;
+    if (z + 1 < CHUNK_D) r.Tzp = S.T_curr.data() + base + CELL_SZ;
+    else if (nb.halo)    r.Tzp = nb.halo->zp.data() + SectionHalo::row(y);
+    else                 r.Tzp = nb.zp ? nb.zp->T_row(cell_ix(0,y,0)) : ZERO_TROW;
+    if (z == 0 && nb.halo)    { r.Tzm = nb.halo->zn.data() + SectionHalo::row(y); r.Kzm = nb.halo->kzn.data() + SectionHalo::row(y); }
+    else if (z == 0 && nb.zn) { r.Tzm = nb.zn->T_row(cell_ix(0,y,CHUNK_D-1)); r.Kzm = nb.zn->kz_edge_row(y); }
+
+    if (nb.halo) {
+        const int i = SectionHalo::col(y, z);
+        r.Txp = temp_decode(nb.halo->xp[i]);
+        r.Txn = temp_decode(nb.halo->xn[i]); r.Kxn = nb.halo->kxn[i];
+        return r;
+    }
+    if (nb.xp) { r.Txp = temp_decode(nb.xp->T_at(cell_ix(0,y,z))); }
+    if (nb.xn) { r.Txn = temp_decode(nb.xn->T_at(cell_ix(CHUNK_W-1,y,z))); r.Kxn = nb.xn->kx_edge(y, z); }
+    return r;
+}
+
+inline float simulate_section_flux_scalar(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    float maxDelta = 0.0f;
+    float qyBelow[CHUNK_D*CHUNK_W];   // faces under the current plane, [z][x]
+    float qzBack[CHUNK_W];            // faces behind the current row
+
+    for_each_section_row(sy, [&](int y, int z) {
+        const SectionRowFlux r = section_row_flux(S, nb, y, z);
+        const int base = cell_ix(0,y,z);
+        const bool firstPlane = (y & (SECTION_EDGE-1)) == 0;
+        uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+        const temp_t*   T   = S.T_curr.data() + base;
+        const float*    KX  = S.kx.data()     + base;
+        const float*    DTC = S.dtC.data()    + base;
+        temp_t*         Tn  = out + base;
+        float*          qyB = qyBelow + z*CHUNK_W;
+
+        float qxBack = r.Kxn * (temp_decode(T[0]) - r.Txn);
+        for (int x=0; x<CHUNK_W; ++x) {
+            const float Tc  = temp_decode(T[x]);
+            const float Txp = (x + 1 < CHUNK_W) ? temp_decode(T[x+1]) : r.Txp;
+            if (firstPlane) qyB[x]    = r.Kym[x] * (Tc - temp_decode(r.Tym[x]));
+            if (z == 0)     qzBack[x] = r.Kzm[x] * (Tc - temp_decode(r.Tzm[x]));
+            const float qx = KX[x]    * (Txp                   - Tc);
+            const float qy = r.Kyp[x] * (temp_decode(r.Typ[x]) - Tc);
+            const float qz = r.Kzp[x] * (temp_decode(r.Tzp[x]) - Tc);
+
+            float dT = 0.0f;
+            dT += qx;
+            dT -= qxBack;
+            dT += qy;
+            dT -= qyB[x];
+            dT += qz;
+            dT -= qzBack[x];
+            qxBack = qx; qyB[x] = qy; qzBack[x] = qz;
+
+            if (anyVoid && M[x] == C.void_ix) { Tn[x] = T[x]; continue; }
+            float Tnew = Tc + DTC[x] * dT;
+            if      (Tnew <   0.0f) Tnew = 0.0f;
+            else if (Tnew > 6000.0f) Tnew = 6000.0f;
+            Tn[x] = temp_encode(Tnew);
+            maxDelta = std::max(maxDelta, std::fabs(Tnew - Tc));
+        }
+    });
+    return maxDelta;
+}
+
+// ====== SIMD section kernels (one 16-wide X row per instruction group) ======
+// Same operation order as the scalar kernel (no FMA, IEEE div), so results match it bitwise.
+#ifdef SIM_X86_SIMD
+// ---- AVX2: two 8-lane halves per row ----
+SIM_TARGET_AVX2 inline __m256 avx2_face_flux(__m256 k, __m256 Tn, __m256 Tc) {
+    return _mm256_mul_ps(k, _mm256_sub_ps(Tn, Tc));
+}
+// 8 stored temperatures <-> fp32. Stores expect values already clamped to [0, SIM_T_MAX].
+SIM_TARGET_AVX2 inline __m256 avx2_load_temp(const temp_t* p) {
+#if SIM_TEMP_STORAGE == SIM_TEMP_F32
+    return _mm256_loadu_ps(p);
+#elif SIM_TEMP_STORAGE == SIM_TEMP_F16
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+#else
+    const __m256i u = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(u), _mm256_set1_ps(TEMP_U16_STEP));
+#endif
+}
+SIM_TARGET_AVX2 inline void avx2_store_temp(temp_t* p, __m256 v) {
+#if SIM_TEMP_STORAGE == SIM_TEMP_F32
+    _mm256_storeu_ps(p, v);
+#elif SIM_TEMP_STORAGE == SIM_TEMP_F16
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+    const __m256i u = _mm256_cvtps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(TEMP_U16_INV)));  // round-to-nearest-even
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packus_epi32(_mm256_castsi256_si128(u), _mm256_extracti128_si256(u, 1)));
+#endif
+}
+SIM_TARGET_AVX2 inline float simulate_section_avx2(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const __m256  zero  = _mm256_setzero_ps();
+    const __m256  absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vMaxDelta = zero;
+    const __m256  vTmax = _mm256_set1_ps(6000.0f);
+    const __m256i vVoid = _mm256_set1_epi32(C.void_ix);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+
+    for_each_section_row(sy, [&](int y, int z) SIM_TARGET_AVX2 {
+        const int base = cell_ix(0,y,z);
+        const SectionRowNeighbors r = section_row_neighbors(S, nb, y, z);
+        const temp_t*   T  = S.T_curr.data() + base;
+        const float*    KX = S.kx.data() + base;
+        alignas(16) uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+
+        // Row padded with the x-neighbor cells so +x/-x are plain unaligned loads.
+        alignas(32) float Tpad[CHUNK_W + 2], Kpad[CHUNK_W + 1];
+        Tpad[0] = r.Txn; Tpad[CHUNK_W+1] = r.Txp; Kpad[0] = r.Kxn;
+        for (int h=0; h<CHUNK_W; h+=8) {
+            _mm256_storeu_ps(Tpad + 1 + h, avx2_load_temp(T + h));
+            _mm256_storeu_ps(Kpad + 1 + h, _mm256_loadu_ps(KX + h));
+        }
+
+        for (int h=0; h<CHUNK_W; h+=8) {
+            const __m256 Tc = _mm256_loadu_ps(Tpad + 1 + h);
+            __m256 dT = zero;
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(KX + h),      _mm256_loadu_ps(Tpad + 2 + h),  Tc));
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(Kpad + h),    _mm256_loadu_ps(Tpad + h),      Tc));
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(r.Kyp + h),   avx2_load_temp(r.Typ + h),      Tc));
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(r.Kym + h),   avx2_load_temp(r.Tym + h),      Tc));
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(r.Kzp + h),   avx2_load_temp(r.Tzp + h),      Tc));
+            dT = _mm256_add_ps(dT, avx2_face_flux(_mm256_loadu_ps(r.Kzm + h),   avx2_load_temp(r.Tzm + h),      Tc));
+
+            __m256 Tnew = _mm256_add_ps(Tc, _mm256_mul_ps(_mm256_loadu_ps(S.dtC.data() + base + h), dT));
+            Tnew = _mm256_max_ps(zero, _mm256_min_ps(Tnew, vTmax));
+
+            if (anyVoid) {
+                const __m256i mix = _mm256_cvtepu16_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(M + h)));
+                const __m256 isVoid = _mm256_castsi256_ps(_mm256_cmpeq_epi32(mix, vVoid));
+                Tnew = _mm256_blendv_ps(Tnew, Tc, isVoid);
+            }
+            avx2_store_temp(out + base + h, Tnew);
+            vMaxDelta = _mm256_max_ps(vMaxDelta, _mm256_and_ps(_mm256_sub_ps(Tnew, Tc), absMask));
+        }
+    });
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(vMaxDelta), _mm256_extractf128_ps(vMaxDelta, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+// ---- AVX-512: one full 16-lane row (CHUNK_W == 16) ----
+static_assert(CHUNK_W == 16, "AVX-512 kernel maps one X row onto 16 float lanes");
+// avx512f implies FMA for GCC's contraction; the explicit-rounding form keeps mul+add unfused.
+SIM_TARGET_AVX512 inline __m512 avx512_mul(__m512 a, __m512 b) {
+    return _mm512_mul_round_ps(a, b, _MM_FROUND_CUR_DIRECTION);
+}
+SIM_TARGET_AVX512 inline __m512 avx512_face_flux(__m512 k, __m512 Tn, __m512 Tc) {
+    return avx512_mul(k, _mm512_sub_ps(Tn, Tc));
+}
+SIM_TARGET_AVX512 inline __m512 avx512_load_temp(const temp_t* p) {
+#if SIM_TEMP_STORAGE == SIM_TEMP_F32
+    return _mm512_loadu_ps(p);
+#elif SIM_TEMP_STORAGE == SIM_TEMP_F16
+    return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+#else
+    const __m512i u = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    return avx512_mul(_mm512_cvtepi32_ps(u), _mm512_set1_ps(TEMP_U16_STEP));
+#endif
+}
+SIM_TARGET_AVX512 inline void avx512_store_temp(temp_t* p, __m512 v) {
+#if SIM_TEMP_STORAGE == SIM_TEMP_F32
+    _mm512_storeu_ps(p, v);
+#elif SIM_TEMP_STORAGE == SIM_TEMP_F16
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#else
+    const __m512i u = _mm512_cvtps_epi32(avx512_mul(v, _mm512_set1_ps(TEMP_U16_INV)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtepi32_epi16(u));
+#endif
+}
+// Lanes shifted down by one with `in` entering lane 15 (+x), or up by one with `in` entering lane 0 (-x).
+SIM_TARGET_AVX512 inline __m512 avx512_shift_in_hi(__m512 v, float in) {
+    return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(_mm512_set1_ps(in)), _mm512_castps_si512(v), 1));
+}
+SIM_TARGET_AVX512 inline __m512 avx512_shift_in_lo(__m512 v, float in) {
+    return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(v), _mm512_castps_si512(_mm512_set1_ps(in)), 15));
+}
+SIM_TARGET_AVX512 inline float simulate_section_avx512(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const __m512  zero  = _mm512_setzero_ps();
+    __m512 vMaxDelta = zero;
+    const __m512  vTmax = _mm512_set1_ps(6000.0f);
+    const __m512i vVoid = _mm512_set1_epi32(C.void_ix);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+
+    for_each_section_row(sy, [&](int y, int z) SIM_TARGET_AVX512 {
+        const int base = cell_ix(0,y,z);
+        const SectionRowNeighbors r = section_row_neighbors(S, nb, y, z);
+
+        const __m512 Tc = avx512_load_temp(S.T_curr.data() + base);
+        const __m512 kx = _mm512_loadu_ps(S.kx.data() + base);
+
+        __m512 dT = zero;
+        dT = _mm512_add_ps(dT, avx512_face_flux(kx, avx512_shift_in_hi(Tc, r.Txp), Tc));
+        dT = _mm512_add_ps(dT, avx512_face_flux(avx512_shift_in_lo(kx, r.Kxn), avx512_shift_in_lo(Tc, r.Txn), Tc));
+        dT = _mm512_add_ps(dT, avx512_face_flux(_mm512_loadu_ps(r.Kyp), avx512_load_temp(r.Typ), Tc));
+        dT = _mm512_add_ps(dT, avx512_face_flux(_mm512_loadu_ps(r.Kym), avx512_load_temp(r.Tym), Tc));
+        dT = _mm512_add_ps(dT, avx512_face_flux(_mm512_loadu_ps(r.Kzp), avx512_load_temp(r.Tzp), Tc));
+        dT = _mm512_add_ps(dT, avx512_face_flux(_mm512_loadu_ps(r.Kzm), avx512_load_temp(r.Tzm), Tc));
+
+        __m512 Tnew = _mm512_add_ps(Tc, avx512_mul(_mm512_loadu_ps(S.dtC.data() + base), dT));
+        Tnew = _mm512_max_ps(zero, _mm512_min_ps(Tnew, vTmax));
+
+        if (anyVoid) {
+            alignas(32) uint16_t M[CHUNK_W];
+            S.matIx.decode_row(base, M);
+            const __m512i mix = _mm512_cvtepu16_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(M)));
+            Tnew = _mm512_mask_blend_ps(_mm512_cmpeq_epi32_mask(mix, vVoid), Tnew, Tc);
+        }
+        avx512_store_temp(out + base, Tnew);
+        vMaxDelta = _mm512_max_ps(vMaxDelta, _mm512_abs_ps(_mm512_sub_ps(Tnew, Tc)));
+    });
+    return _mm512_reduce_max_ps(vMaxDelta);
+}
+
+// ---- Flux form (see simulate_section_flux_scalar) ----
+SIM_TARGET_AVX2 inline float simulate_section_flux_avx2(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const __m256  zero  = _mm256_setzero_ps();
+    const __m256  absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vMaxDelta = zero;
+    const __m256  vTmax = _mm256_set1_ps(6000.0f);
+    const __m256i vVoid = _mm256_set1_epi32(C.void_ix);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    alignas(32) float qyBelow[CHUNK_D*CHUNK_W];
+    __m256 qzBack[2] = {zero, zero};
+
+    for_each_section_row(sy, [&](int y, int z) SIM_TARGET_AVX2 {
+        const int base = cell_ix(0,y,z);
+        const SectionRowFlux r = section_row_flux(S, nb, y, z);
+        const bool firstPlane = (y & (SECTION_EDGE-1)) == 0;
+        const temp_t*   T  = S.T_curr.data() + base;
+        const float*    KX = S.kx.data() + base;
+        float*          qyB = qyBelow + z*CHUNK_W;
+        alignas(16) uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+
+        // Row with the +x cell appended; +x faces with the -x boundary face in front, so the
+        // face behind each cell is a plain unaligned load.
+        alignas(32) float Tpad[CHUNK_W + 1], Qpad[CHUNK_W + 1];
+        Tpad[CHUNK_W] = r.Txp;
+        for (int h=0; h<CHUNK_W; h+=8) _mm256_storeu_ps(Tpad + h, avx2_load_temp(T + h));
+        Qpad[0] = r.Kxn * (Tpad[0] - r.Txn);
+        for (int h=0; h<CHUNK_W; h+=8)
+            _mm256_storeu_ps(Qpad + 1 + h, avx2_face_flux(_mm256_loadu_ps(KX + h), _mm256_loadu_ps(Tpad + 1 + h), _mm256_loadu_ps(Tpad + h)));
+
+        for (int h=0; h<CHUNK_W; h+=8) {
+            const __m256 Tc = _mm256_loadu_ps(Tpad + h);
+            if (firstPlane) _mm256_store_ps(qyB + h, avx2_face_flux(_mm256_loadu_ps(r.Kym + h), Tc, avx2_load_temp(r.Tym + h)));
+            if (z == 0)     qzBack[h/8] = avx2_face_flux(_mm256_loadu_ps(r.Kzm + h), Tc, avx2_load_temp(r.Tzm + h));
+            const __m256 qy = avx2_face_flux(_mm256_loadu_ps(r.Kyp + h), avx2_load_temp(r.Typ + h), Tc);
+            const __m256 qz = avx2_face_flux(_mm256_loadu_ps(r.Kzp + h), avx2_load_temp(r.Tzp + h), Tc);
+
+            __m256 dT = zero;
+            dT = _mm256_add_ps(dT, _mm256_loadu_ps(Qpad + 1 + h));
+            dT = _mm256_sub_ps(dT, _mm256_loadu_ps(Qpad + h));
+            dT = _mm256_add_ps(dT, qy);
+            dT = _mm256_sub_ps(dT, _mm256_load_ps(qyB + h));
+            dT = _mm256_add_ps(dT, qz);
+            dT = _mm256_sub_ps(dT, qzBack[h/8]);
+            _mm256_store_ps(qyB + h, qy);
+            qzBack[h/8] = qz;
+
+            __m256 Tnew = _mm256_add_ps(Tc, _mm256_mul_ps(_mm256_loadu_ps(S.dtC.data() + base + h), dT));
+            Tnew = _mm256_max_ps(zero, _mm256_min_ps(Tnew, vTmax));
+
+            if (anyVoid) {
+                const __m256i mix = _mm256_cvtepu16_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(M + h)));
+                const __m256 isVoid = _mm256_castsi256_ps(_mm256_cmpeq_epi32(mix, vVoid));
+                Tnew = _mm256_blendv_ps(Tnew, Tc, isVoid);
+            }
+            avx2_store_temp(out + base + h, Tnew);
+            vMaxDelta = _mm256_max_ps(vMaxDelta, _mm256_and_ps(_mm256_sub_ps(Tnew, Tc), absMask));
+        }
+    });
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(vMaxDelta), _mm256_extractf128_ps(vMaxDelta, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+SIM_TARGET_AVX512 inline float simulate_section_flux_avx512(Chunk& C, int sy, temp_t* out) {
+    Section& S = *C.section(sy);
+    const SectionNeighbors nb = kernel_section_neighbors(C, sy);
+    const __m512  zero  = _mm512_setzero_ps();
+    __m512 vMaxDelta = zero;
+    const __m512  vTmax = _mm512_set1_ps(6000.0f);
+    const __m512i vVoid = _mm512_set1_epi32(C.void_ix);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    alignas(64) float qyBelow[CHUNK_D*CHUNK_W];
+    __m512 qzBack = zero;
+
+    for_each_section_row(sy, [&](int y, int z) SIM_TARGET_AVX512 {
+        const int base = cell_ix(0,y,z);
+        const SectionRowFlux r = section_row_flux(S, nb, y, z);
+        const bool firstPlane = (y & (SECTION_EDGE-1)) == 0;
+        float* qyB = qyBelow + z*CHUNK_W;
+
+        const __m512 Tc = avx512_load_temp(S.T_curr.data() + base);
+        if (firstPlane) _mm512_store_ps(qyB, avx512_face_flux(_mm512_loadu_ps(r.Kym), Tc, avx512_load_temp(r.Tym)));
+        if (z == 0)     qzBack = avx512_face_flux(_mm512_loadu_ps(r.Kzm), Tc, avx512_load_temp(r.Tzm));
+        const __m512 qx = avx512_face_flux(_mm512_loadu_ps(S.kx.data() + base), avx512_shift_in_hi(Tc, r.Txp), Tc);
+        const __m512 qy = avx512_face_flux(_mm512_loadu_ps(r.Kyp), avx512_load_temp(r.Typ), Tc);
+        const __m512 qz = avx512_face_flux(_mm512_loadu_ps(r.Kzp), avx512_load_temp(r.Tzp), Tc);
+        const float  qxn = r.Kxn * (temp_decode(S.T_curr[base]) - r.Txn);
+
+        __m512 dT = zero;
+        dT = _mm512_add_ps(dT, qx);
+        dT = _mm512_sub_ps(dT, avx512_shift_in_lo(qx, qxn));
+        dT = _mm512_add_ps(dT, qy);
+        dT = _mm512_sub_ps(dT, _mm512_load_ps(qyB));
+        dT = _mm512_add_ps(dT, qz);
+        dT = _mm512_sub_ps(dT, qzBack);
+        _mm512_store_ps(qyB, qy);
+        qzBack = qz;
+
+        __m512 Tnew = _mm512_add_ps(Tc, avx512_mul(_mm512_loadu_ps(S.dtC.data() + base), dT));
+        Tnew = _mm512_max_ps(zero, _mm512_min_ps(Tnew, vTmax));
+
+        if (anyVoid) {
+            alignas(32) uint16_t M[CHUNK_W];
+            S.matIx.decode_row(base, M);
+            const __m512i mix = _mm512_cvtepu16_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(M)));
+            Tnew = _mm512_mask_blend_ps(_mm512_cmpeq_epi32_mask(mix, vVoid), Tnew, Tc);
+        }
+        avx512_store_temp(out + base, Tnew);
+        vMaxDelta = _mm512_max_ps(vMaxDelta, _mm512_abs_ps(_mm512_sub_ps(Tnew, Tc)));
+    });
+    return _mm512_reduce_max_ps(vMaxDelta);
+}
+#endif // SIM_X86_SIMD
+
+// ====== Kernel selection (CPU feature detection once at startup) ======
+enum class SimKernel : uint8_t { Scalar, AVX2, AVX512 };
+
+inline const char* sim_kernel_name(SimKernel k) {
+    switch (k) {
+        case SimKernel::AVX512: return "avx512";
+        case SimKernel::AVX2:   return "avx2";
+        default:                return "scalar";
+    }
+}
+inline SimKernel detect_sim_kernel() {
+#ifdef SIM_X86_SIMD
+    if (SDL_HasAVX512F()) return SimKernel::AVX512;
+    if (SDL_HasAVX2())    return SimKernel::AVX2;
+#endif
+    return SimKernel::Scalar;
+}
+// Best supported variant, picked on first use. Assign to force a variant (e.g. Scalar for A/B runs);
+// forcing a variant the CPU lacks is clamped back to what detect_sim_kernel() allows.
+inline SimKernel& active_sim_kernel() {
+    static SimKernel k = detect_sim_kernel();
+    return k;
+}
+inline void set_sim_kernel(SimKernel k) {
+    active_sim_kernel() = std::min(k, detect_sim_kernel());
+}
+
+// Cell: every cell evaluates its six faces. Flux: each face evaluated once and carried to the
+// plus-side cell. Both produce bit-identical T_next; assign for A/B runs.
+enum class SimStencil : uint8_t { Cell, Flux };
+
+inline const char* sim_stencil_name(SimStencil s) { return s == SimStencil::Flux ? "flux" : "cell"; }
+inline SimStencil& active_sim_stencil() {
+    static SimStencil s = SimStencil::Flux;
+    return s;
+}
+
+// Advances one loaded, dense section into `out` (SECTION_N cells; default T_next) and returns its
+// max |dT|. Coefficients (and the halo, if any) must be current.
+inline float simulate_section_16x16x16(Chunk& C, int sy, temp_t* out = nullptr) {
+    if (!out) out = C.section(sy)->T_next.writable(false);
+    if (active_sim_stencil() == SimStencil::Flux) {
+        switch (active_sim_kernel()) {
+#ifdef SIM_X86_SIMD
+            case SimKernel::AVX512: return simulate_section_flux_avx512(C, sy, out);
+            case SimKernel::AVX2:   return simulate_section_flux_avx2(C, sy, out);
+#endif
+            default:                return simulate_section_flux_scalar(C, sy, out);
+        }
+    }
+    switch (active_sim_kernel()) {
+#ifdef SIM_X86_SIMD
+        case SimKernel::AVX512: return simulate_section_avx512(C, sy, out);
+        case SimKernel::AVX2:   return simulate_section_avx2(C, sy, out);
+#endif
+        default:                return simulate_section_scalar(C, sy, out);
+    }
+}
+// ====== Uniform sections: skip or promote ======
+// A uniform section is exactly static for a frame when every cell across its six faces holds the
+// same temperature (air and missing chunks count as equal): each face adds k*0, so T + dtC*0 == T.
+// Its own T must also pass the [0, 6000] clamp unchanged (no -0, no NaN).
+inline bool uniform_section_static(const World& world, const Chunk& C, int sy) {
+    const Section& S = *C.section(sy);
+    const float T = temp_decode(S.uniformRow[0]);
+    if (!(T >= 0.0f && T <= SIM_T_MAX) || std::signbit(T)) return false;
+
+    const SectionNeighbors nb = resolve_section_neighbors(world, C, sy);
     const int y0 = sy * SECTION_EDGE;
-    const int y1 = y0 + SECTION_EDGE;
-    constexpr float inv_dx2 = 1.0f;
-
-    for (int z=0; z<CHUNK_D; ++z) {
-        for (int y=y0; y<y1; ++y) {
-            for (int x=0; x<CHUNK_W; ++x) {
-                const int i = idx(x,y,z);
-                const uint16_t mix = C.matIx[i];
-                if (mix == C.void_ix) { C.T_next[i] = C.T_curr[i]; continue; }
-
-                const Material& m  = mats.byIx(mix);
-                // Thermal capacity of this cell = mass(kg) * heatCapacity(J/kg*K)
-                const float Cth    = std::max(1e-8f, C.mass_kg[i] * m.heatCapacity);
-                const float Tc     = C.T_curr[i];
-
-                NeighborSample nb[6] = {
-                    sample_neighbor_T(world, C, x,y,z, +1, 0, 0),
-                    sample_neighbor_T(world, C, x,y,z, -1, 0, 0),
-                    sample_neighbor_T(world, C, x,y,z,  0,+1, 0),
-                    sample_neighbor_T(world, C, x,y,z,  0,-1, 0),
-                    sample_neighbor_T(world, C, x,y,z,  0, 0,+1),
-                    sample_neighbor_T(world, C, x,y,z,  0, 0,-1),
-                };
-
-                float dT = 0.0f;
-                for (int n=0;n<6;++n) {
-                    if (!nb[n].exists) continue;
-                    const Material& mn = mats.byIx(nb[n].mix);
-                    const float k1 = m.thermalConductivity, k2 = mn.thermalConductivity;
-                    float k_eff = 0.0f;
-                    //if (k1 > 0.0f && k2 > 0.0f) k_eff = 2.0f * k1 * k2 / (k1 + k2);
-                    //else                        k_eff = std::max(k1, k2);
-                    if (k1 <= 0.0f || k2 <= 0.0f) {
-                        k_eff = 0.0f;
-                    } else {
-                        k_eff = 2.0f * k1 * k2 / (k1 + k2);
-                    }
-                    dT += (k_eff * (nb[n].T - Tc)) * inv_dx2;
+    // cellOf(a, b) walks the 16x16 plane of N that touches this section.
+    auto planeEquals = [&](const Section* N, auto cellOf) {
+        if (!N) return true;
+        if (!N->dense) return temp_decode(N->uniformRow[0]) == T;
+        for (int a=0; a<SECTION_EDGE; ++a)
+            for (int b=0; b<SECTION_EDGE; ++b)
+                if (!(temp_decode(N->T_curr[cellOf(a, b)]) == T)) return false;
+        return true;
+    };
+    return planeEquals(nb.xn, [&](int a, int b){ return cell_ix(CHUNK_W-1, y0+a, b); })
+        && planeEquals(nb.xp, [&](int a, int b){ return cell_ix(0, y0+a, b); })
+        && planeEquals(nb.yn, [&](int a, int b){ return cell_ix(b, y0-1, a); })
+        && planeEquals(nb.yp, [&](int a, int b){ return cell_ix(b, y0+SECTION_EDGE, a); })
+        && planeEquals(nb.zn, [&](int a, int b){ return cell_ix(b, y0+a, CHUNK_D-1); })
+        && planeEquals(nb.zp, [&](int a, int b){ return cell_ix(b, y0+a, 0); });
+}
+// Makes dense every uniform section that would change this frame. All decisions are taken before
+// any promotion, so the result does not depend on iteration order. Returns the number promoted.
+inline int promote_uniform_sections(World& world) {
+    std::vector<std::pair<Chunk*, int>> wake;
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const Section* S = C.section(sy);
+            if (S && !S->dense && !uniform_section_static(world, C, sy)) wake.emplace_back(&C, sy);
+        }
+    }
+    for (auto& [C, sy] : wake) {
+        C->section(sy)->make_dense();
+        C->coeffDirty[sy] = 1;
+    }
+    return (int)wake.size();
+}
+
+// ====== Section sleep/wake ======
+// Runs before the coefficient refresh, so coeffDirty still flags sections edited since last frame
+// (set_cell, fill_section_with, allocation/release); a dt change counts as an edit everywhere.
+// Works on last frame's maxDelta and ranLast; all decisions are taken before any state changes.
+inline void update_section_sleep(World& world, float dt_seconds) {
+    const SleepConfig cfg = world.sleep;
+    // "changed" = edited, or ran last frame with activity above epsilon
+    auto changed = [&](const Chunk* N, int sy) {
+        if (!N || sy < 0 || sy >= SECTIONS_Y) return false;
+        return N->coeffDirty[sy] || N->coeff_dt != dt_seconds
+            || (N->ranLast[sy] && !(N->maxDelta[sy] <= std::max(cfg.epsilon, 0.0f)));
+    };
+    std::vector<std::pair<Chunk*, int>> sleepers, wakers;
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        const Chunk* nxn = C.xn;
+        const Chunk* nxp = C.xp;
+        const Chunk* nzn = C.zn;
+        const Chunk* nzp = C.zp;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const Section* S = C.section(sy);
+            if (!S || !S->dense) continue;
+            const bool self    = changed(&C, sy);
+            const bool nearby  = changed(&C, sy - 1) || changed(&C, sy + 1)
+                              || changed(nxn, sy) || changed(nxp, sy) || changed(nzn, sy) || changed(nzp, sy);
+            if (cfg.epsilon < 0.0f || self || nearby) wakers.emplace_back(&C, sy);
+            else if (C.ranLast[sy] || C.asleep[sy])   sleepers.emplace_back(&C, sy);
+        }
+    }
+    for (auto& [C, sy] : wakers) { C->asleep[sy] = 0; C->calmFrames[sy] = 0; }
+    for (auto& [C, sy] : sleepers) {
+        if (C->ranLast[sy] && C->calmFrames[sy] < 0xffff) ++C->calmFrames[sy];
+        if (C->calmFrames[sy] >= cfg.frames) C->asleep[sy] = 1;
+    }
+}
+
+struct SectionActivity { size_t awake = 0, asleep = 0, uniform = 0; };
+inline SectionActivity world_section_activity(const World& world) {
+    SectionActivity a;
+    for (const auto& kv : world.chunks) {
+        const Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const Section* S = C.section(sy);
+            if (!S)             continue;
+            if (!S->dense)      ++a.uniform;
+            else if (C.asleep[sy]) ++a.asleep;
+            else                ++a.awake;
+        }
+    }
+    return a;
+}
+
+// ====== Implicit solver (backward Euler, Jacobi-preconditioned CG) ======
+// Solves  T'/dtC + sum_f k_f (T' - T'_f) = T/dtC  for every non-void cell of every loaded section,
+// with the same cached harmonic face conductances as the explicit kernels (matrix-free). The
+// operator is symmetric positive definite (capacity on the diagonal plus a graph Laplacian), so
+// CG converges for any dt. Void cells keep their temperature and act as fixed boundaries; faces
+// toward air / missing chunks are 0 as before. Work is split per section on the pool; dot
+// products are summed per section in double and reduced in section order, so the result does
+// not depend on the pool size.
+struct ImplicitSection {
+    Chunk* C; int sy; Section* S;
+    SectionNeighbors nb;
+    std::array<int, 6> slot;  // xn, xp, zn, zp, yn, yp: neighbor section index, -1 = none
+    bool anyVoid;
+};
+
+// Calls f(k, j) for the six faces of cell (x,y,z) in +x,-x,+y,-y,+z,-z order, where j is the
+// neighbor cell's index into the solve vectors. Faces toward a missing section are skipped (k = 0).
+template<class F>
+inline void implicit_cell_faces(const ImplicitSection& e, int self, int x, int y, int z, F&& f) {
+    const Section& S = *e.S;
+    const int i  = cell_ix(x,y,z);
+    const int yl = y & (SECTION_EDGE-1);
+    auto at = [](int s, int j) { return s * SECTION_N + j; };
+
+    if (x + 1 < CHUNK_W)      f(S.kx[i], at(self, i + CELL_SX));
+    else if (e.slot[1] >= 0)  f(S.kx[i], at(e.slot[1], cell_ix(0,y,z)));
+    if (x > 0)                f(S.kx[i - CELL_SX], at(self, i - CELL_SX));
+    else if (e.slot[0] >= 0)  f(e.nb.xn->kx_edge(y, z), at(e.slot[0], cell_ix(CHUNK_W-1,y,z)));
+    if (yl + 1 < SECTION_EDGE) f(S.ky[i], at(self, i + CELL_SY));
+    else if (e.slot[5] >= 0)  f(S.ky[i], at(e.slot[5], cell_ix(x,y+1,z)));
+    if (yl > 0)               f(S.ky[i - CELL_SY], at(self, i - CELL_SY));
+    else if (e.slot[4] >= 0)  f(e.nb.yn->ky_top_row(z)[x], at(e.slot[4], cell_ix(x,y-1,z)));
+    if (z + 1 < CHUNK_D)      f(S.kz[i], at(self, i + CELL_SZ));
+    else if (e.slot[3] >= 0)  f(S.kz[i], at(e.slot[3], cell_ix(x,y,0)));
+    if (z > 0)                f(S.kz[i - CELL_SZ], at(self, i - CELL_SZ));
+    else if (e.slot[2] >= 0)  f(e.nb.zn->kz_edge_row(y)[x], at(e.slot[2], cell_ix(x,y,CHUNK_D-1)));
+}
+
+// dst = (withCapacity ? u/dtC : 0) + sum_f k_f (u - u_f) over section `self`; void cells get 0.
+// Callers keep search directions at 0 on void cells, so those faces act as fixed boundaries.
+inline void implicit_apply(const ImplicitSection& e, int self, const float* u, float* dst, bool withCapacity) {
+    const Section& S = *e.S;
+    const uint16_t void_ix = e.C->void_ix;
+    for_each_section_row(e.sy, [&](int y, int z) {
+        const int base = cell_ix(0,y,z);
+        uint16_t M[CHUNK_W];
+        if (e.anyVoid) S.matIx.decode_row(base, M);
+        const float* us = u   + self * SECTION_N;
+        float*       ds = dst + self * SECTION_N;
+        for (int x=0; x<CHUNK_W; ++x) {
+            const int i = base + x;
+            if (e.anyVoid && M[x] == void_ix) { ds[i] = 0.0f; continue; }
+            const float uc = us[i];
+            float a = withCapacity ? uc / S.dtC[i] : 0.0f;
+            implicit_cell_faces(e, self, x, y, z, [&](float k, int j) { a += k * (uc - u[j]); });
+            ds[i] = a;
+        }
+    });
+}
+
+// One backward-Euler step of every loaded section into T_next (uniform sections are made dense
+// first: the implicit update couples every cell). Coefficients must be current for this dt.
+// Returns the solver statistics; per-section maxDelta is filled as in the explicit path.
+inline ImplicitStats implicit_solve_to_backbuffers(World& world, SimWorkerPool* pool) {
+    ImplicitWorkspace& ws = world.implicitWork;
+    std::vector<ImplicitSection>& secs = ws.secs;
+    secs.clear();
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        C.solveBase = (int)secs.size();
+        for (int sy=0; sy<SECTIONS_Y; ++sy)
+            if (Section* S = C.section(sy))
+                secs.push_back(ImplicitSection{&C, sy, S, {}, {}, S->matIx.contains(C.void_ix)});
+    }
+    // A chunk's loaded sections take the slots from its solveBase on, in sy order.
+    auto slotOf = [](const Chunk* N, int sy) {
+        if (!N || !N->section(sy)) return -1;
+        int s = N->solveBase;
+        for (int b=0; b<sy; ++b) s += N->section(b) != nullptr;
+        return s;
+    };
+    for (ImplicitSection& e : secs) {
+        const Chunk& C = *e.C;
+        e.nb = resolve_section_neighbors(world, C, e.sy);
+        e.slot = {slotOf(C.xn, e.sy), slotOf(C.xp, e.sy), slotOf(C.zn, e.sy), slotOf(C.zp, e.sy),
+                  e.sy > 0 ? slotOf(&C, e.sy - 1) : -1, e.sy + 1 < SECTIONS_Y ? slotOf(&C, e.sy + 1) : -1};
+    }
+
+    const int n = (int)secs.size();
+    const size_t N = size_t(n) * SECTION_N;
+    for (auto* v : {&ws.x, &ws.r, &ws.z, &ws.p, &ws.q, &ws.minv})
+        if (v->size() < N) v->resize(N);
+    if (ws.part.size() < size_t(n)) ws.part.resize(n);
+    std::vector<float> &x = ws.x, &r = ws.r, &z = ws.z, &p = ws.p, &q = ws.q, &minv = ws.minv;
+    std::vector<double>& part = ws.part;
+    auto forSections = [&](auto&& fn) {
+        if (pool) pool->run(n, fn);
+        else      for (int s=0; s<n; ++s) fn(s);
+    };
+    auto reduce = [&]() { double acc = 0.0; for (int s=0; s<n; ++s) acc += part[s]; return acc; };
+    auto isVoid = [&](const ImplicitSection& e, int i) { return e.anyVoid && e.S->matIx.get(i) == e.C->void_ix; };
+
+    // x = T, inverse Jacobi diagonal
+    forSections([&](int s) {
+        const ImplicitSection& e = secs[s];
+        float* xs = x.data() + size_t(s) * SECTION_N;
+        for (int i=0; i<SECTION_N; ++i) xs[i] = temp_decode(e.S->T_curr[i]);
+        for_each_section_row(e.sy, [&](int y, int zz) {
+            for (int xx=0; xx<CHUNK_W; ++xx) {
+                const int i = cell_ix(xx,y,zz);
+                if (isVoid(e, i)) { minv[size_t(s) * SECTION_N + i] = 0.0f; continue; }
+                float d = 1.0f / e.S->dtC[i];
+                implicit_cell_faces(e, s, xx, y, zz, [&](float k, int) { d += k; });
+                minv[size_t(s) * SECTION_N + i] = 1.0f / d;
+            }
+        });
+    });
+
+    // r = b - A x = -sum_f k_f (T - T_f) (the explicit flux), z = M^-1 r, p = z
+    forSections([&](int s) {
+        implicit_apply(secs[s], s, x.data(), r.data(), /*withCapacity=*/false);
+        double rz = 0.0;
+        for (size_t i = size_t(s) * SECTION_N, e = i + SECTION_N; i < e; ++i) {
+            r[i] = -r[i];
+            z[i] = minv[i] * r[i];
+            p[i] = z[i];
+            rz += double(r[i]) * z[i];
+        }
+        part[s] = rz;
+    });
+    double rz = reduce();
+    const double rz0 = rz;
+    const double tol2 = double(world.implicit.tolerance) * world.implicit.tolerance;
+
+    int it = 0;
+    while (it < world.implicit.maxIters && rz > tol2 * rz0) {
+        forSections([&](int s) {
+            implicit_apply(secs[s], s, p.data(), q.data(), /*withCapacity=*/true);
+            double pq = 0.0;
+            for (size_t i = size_t(s) * SECTION_N, e = i + SECTION_N; i < e; ++i) pq += double(p[i]) * q[i];
+            part[s] = pq;
+        });
+        const double pq = reduce();
+        if (!(pq > 0.0)) break;
+        const float alpha = float(rz / pq);
+        forSections([&](int s) {
+            double acc = 0.0;
+            for (size_t i = size_t(s) * SECTION_N, e = i + SECTION_N; i < e; ++i) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+                z[i]  = minv[i] * r[i];
+                acc  += double(r[i]) * z[i];
+            }
+            part[s] = acc;
+        });
+        const double rzNew = reduce();
+        const float beta = float(rzNew / rz);
+        rz = rzNew;
+        forSections([&](int s) {
+            for (size_t i = size_t(s) * SECTION_N, e = i + SECTION_N; i < e; ++i) p[i] = z[i] + beta * p[i];
+        });
+        ++it;
+    }
+
+    // T_next = clamp(x); void cells keep T
+    forSections([&](int s) {
+        const ImplicitSection& e = secs[s];
+        Section& S = *e.S;
+        const float* xs = x.data() + size_t(s) * SECTION_N;
+        temp_t* Tn = S.T_next.writable(false);
+        float maxDelta = 0.0f;
+        for (int i=0; i<SECTION_N; ++i) {
+            if (isVoid(e, i)) { Tn[i] = S.T_curr[i]; continue; }
+            const float Tc   = temp_decode(S.T_curr[i]);
+            const float Tnew = std::min(std::max(xs[i], 0.0f), SIM_T_MAX);
+            Tn[i] = temp_encode(Tnew);
+            maxDelta = std::max(maxDelta, std::fabs(Tnew - Tc));
+        }
+        e.C->maxDelta[e.sy] = maxDelta;
+    });
+
+    ImplicitStats st;
+    st.iterations = it;
+    st.residual   = rz0 > 0.0 ? float(std::sqrt(std::max(rz, 0.0) / rz0)) : 0.0f;
+    for (const ImplicitSection& e : secs) st.cells += size_t(e.S->nonVoid);
+    return st;
+}
+
+// ====== Steady state (geometric multigrid) ======
+// Equilibrium field for the current materials: sum_f k_f (T - T_f) = 0 for every free cell.
+// Void cells and cells selected by SteadyStateConfig::pinned keep their temperature (fixed).
+// A conducting region that touches no fixed cell has no unique solution of that equation; its
+// equilibrium is its capacity-weighted mean temperature (energy is conserved), set directly.
+// The other regions are solved with conjugate gradients preconditioned by one multigrid V-cycle
+// over the section hierarchy 16^3 -> 8^3 -> 4^3 -> 2^3 -> 1 cell per section: 2x2x2 aggregation
+// where a coarse face sums the fine faces crossing it (the Galerkin operator of piecewise-constant
+// interpolation), damped Jacobi smoothing, and Jacobi-CG on the coarsest level. Every pass is
+// split per section on the pool; reductions are summed per section and then in section order, so
+// the result does not depend on the pool size.
+struct SteadyStateConfig {
+    double tolerance = 1e-5;  // stop when ||r||_2 fell by this factor (fp32 vectors: ~1e-6 is the floor)
+    int    maxIters  = 100;   // outer CG iterations (one V-cycle each)
+    int    smooth    = 2;     // Jacobi sweeps before and after each coarse correction
+    float  omega     = 0.7f;  // Jacobi damping
+    std::function<bool(const Chunk&, int x, int y, int z)> pinned;  // optional fixed cells (chunk coordinates)
+};
+struct SteadyStateStats {
+    int    iterations  = 0;
+    bool   converged   = true;
+    double residual0   = 0.0;  // ||r||_2 over the multigrid cells before solving, W
+    double residual    = 0.0;  // ||r||_2 after solving (before storage encoding), W
+    double maxResidual = 0.0;  // max |r| after solving, W
+    size_t cells           = 0;  // non-void cells
+    size_t solvedCells     = 0;  // free cells solved by multigrid-CG
+    size_t floatingCells   = 0;  // free cells in regions without fixed cells (set to their mean)
+    size_t floatingRegions = 0;
+};
+
+constexpr int MG_LEVELS = 5;  // edge 16, 8, 4, 2, 1
+
+struct MGLevel {
+    int e = 0;                          // edge length
+    std::vector<uint8_t> active;        // free unknown; inactive entries of the vectors stay 0 (x: fixed T)
+    std::vector<float> d;               // diagonal from faces toward fixed cells (coarse levels)
+    std::vector<float> kx, ky, kz;      // faces toward +x/+y/+z (border faces point into the neighbor section)
+    std::vector<float> Dinv;            // inverse Jacobi diagonal
+    std::vector<float> u, f, t;         // V-cycle: correction, right-hand side, A*u
+    std::vector<float> x, r, p, q;      // CG (level 0 and the coarsest level): solution, residual, direction, A*p
+    int ix(int x_, int y_, int z_) const { return x_ + e * (z_ + e * y_); }
+    void init(int edge) {
+        e = edge;
+        const size_t n = size_t(e) * e * e;
+        active.assign(n, 0);
+        for (auto* v : {&d, &kx, &ky, &kz, &Dinv, &u, &f, &t, &x, &r, &p, &q}) v->assign(n, 0.0f);
+    }
+};
+struct MGSection {
+    Chunk* C; int sy; Section* S;
+    std::array<int, 6> slot;  // xn, xp, zn, zp, yn, yp: neighbor section index, -1 = none
+    std::array<MGLevel, MG_LEVELS> lv;
+};
+using MGVec = std::vector<float> MGLevel::*;
+
+// Calls f(dir, k, sj, j) for the faces of cell (x,y,z) of section s on level l in
+// +x,-x,+y,-y,+z,-z order (dir 0..5); j is the neighbor cell on level l of section sj.
+// Faces toward a missing section are skipped.
+template<class F>
+inline void mg_cell_faces(const std::vector<MGSection>& secs, int s, int l, int x, int y, int z, F&& f) {
+    const MGLevel& L = secs[s].lv[l];
+    const std::array<int, 6>& sl = secs[s].slot;
+    const int e = L.e, i = L.ix(x,y,z);
+    auto nb = [&](int k) -> const MGLevel& { return secs[sl[k]].lv[l]; };
+    if (x + 1 < e)       f(0, L.kx[i], s, L.ix(x+1,y,z));
+    else if (sl[1] >= 0) f(0, L.kx[i], sl[1], L.ix(0,y,z));
+    if (x > 0)           f(1, L.kx[L.ix(x-1,y,z)], s, L.ix(x-1,y,z));
+    else if (sl[0] >= 0) f(1, nb(0).kx[L.ix(e-1,y,z)], sl[0], L.ix(e-1,y,z));
+    if (y + 1 < e)       f(2, L.ky[i], s, L.ix(x,y+1,z));
+    else if (sl[5] >= 0) f(2, L.ky[i], sl[5], L.ix(x,0,z));
+    if (y > 0)           f(3, L.ky[L.ix(x,y-1,z)], s, L.ix(x,y-1,z));
+    else if (sl[4] >= 0) f(3, nb(4).ky[L.ix(x,e-1,z)], sl[4], L.ix(x,e-1,z));
+    if (z + 1 < e)       f(4, L.kz[i], s, L.ix(x,y,z+1));
+    else if (sl[3] >= 0) f(4, L.kz[i], sl[3], L.ix(x,y,0));
+    if (z > 0)           f(5, L.kz[L.ix(x,y,z-1)], s, L.ix(x,y,z-1));
+    else if (sl[2] >= 0) f(5, nb(2).kz[L.ix(x,y,e-1)], sl[2], L.ix(x,y,e-1));
+}
+template<class F>
+inline void mg_for_cells(int e, F&& f) {
+    for (int y=0; y<e; ++y) for (int z=0; z<e; ++z) for (int x=0; x<e; ++x) f(x, y, z, x + e * (z + e * y));
+}
+
+// dst = d*u + sum_f k_f (u - u_f) on the active cells of section s, level l.
+inline void mg_apply(std::vector<MGSection>& secs, int s, int l, MGVec u, MGVec dst) {
+    MGLevel& L = secs[s].lv[l];
+    mg_for_cells(L.e, [&](int x, int y, int z, int i) {
+        if (!L.active[i]) return;
+        const float uc = (L.*u)[i];
+        float a = L.d[i] * uc;
+        mg_cell_faces(secs, s, l, x, y, z, [&](int, float k, int sj, int j) { a += k * (uc - (secs[sj].lv[l].*u)[j]); });
+        (L.*dst)[i] = a;
+    });
+}
+// Level l+1 of section s from level l (reads the neighbor sections' level l only).
+inline void mg_coarsen(std::vector<MGSection>& secs, int s, int l) {
+    const MGLevel& F = secs[s].lv[l];
+    MGLevel& G = secs[s].lv[l + 1];
+    G.init(F.e / 2);
+    mg_for_cells(F.e, [&](int x, int y, int z, int i) {
+        if (!F.active[i]) return;
+        const int I = G.ix(x/2, y/2, z/2);
+        const int c[3] = {x, y, z};
+        G.active[I] = 1;
+        G.d[I] += F.d[i];
+        mg_cell_faces(secs, s, l, x, y, z, [&](int dir, float k, int sj, int j) {
+            if (k == 0.0f) return;
+            if (!secs[sj].lv[l].active[j]) G.d[I] += k;          // face toward a fixed cell
+            else if (!(dir & 1) && (c[dir/2] & 1))               // + face leaving the 2x2x2 block
+                (dir == 0 ? G.kx : dir == 2 ? G.ky : G.kz)[I] += k;
+        });
+    });
+}
+inline void mg_jacobi_diag(std::vector<MGSection>& secs, int s, int l) {
+    MGLevel& L = secs[s].lv[l];
+    mg_for_cells(L.e, [&](int x, int y, int z, int i) {
+        if (!L.active[i]) return;
+        float D = L.d[i];
+        mg_cell_faces(secs, s, l, x, y, z, [&](int, float k, int, int) { D += k; });
+        L.Dinv[i] = D > 0.0f ? 1.0f / D : 0.0f;
+    });
+}
+
+// Writes the equilibrium into T_curr/T_next of every loaded section (uniform sections are made
+// dense first; recomputeSectionLoaded folds uniform results back) and wakes all sections.
+inline SteadyStateStats solve_steady_state(World& world, const SteadyStateConfig& cfg = {}, SimWorkerPool* pool = nullptr) {
+    SteadyStateStats st;
+
+    // Current face conductances on every loaded section (dt does not enter the equilibrium).
+    float dt = 0.0f;
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        dt = std::max(dt, C.coeff_dt);
+        for (int sy=0; sy<SECTIONS_Y; ++sy)
+            if (Section* S = C.section(sy); S && !S->dense) { S->make_dense(); C.coeffDirty[sy] = 1; }
+    }
+    refresh_dirty_coeffs(world, dt > 0.0f ? dt : 1.0f);
+
+    std::vector<MGSection> secs;
+    std::unordered_map<const Section*, int> slotOf;
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y; ++sy)
+            if (Section* S = C.section(sy)) { slotOf.emplace(S, (int)secs.size()); secs.push_back(MGSection{&C, sy, S, {}, {}}); }
+    }
+    const int n = (int)secs.size();
+    if (n == 0) return st;
+    for (MGSection& m : secs) {
+        const SectionNeighbors nb = resolve_section_neighbors(world, *m.C, m.sy);
+        const Section* ns[6] = {nb.xn, nb.xp, nb.zn, nb.zp, nb.yn, nb.yp};
+        for (int f=0; f<6; ++f) m.slot[f] = ns[f] ? slotOf.at(ns[f]) : -1;
+        st.cells += size_t(m.S->nonVoid);
+    }
+    auto forSections = [&](auto&& fn) {
+        if (pool) pool->run(n, fn);
+        else      for (int s=0; s<n; ++s) fn(s);
+    };
+    std::vector<double> part(n);
+    auto reduce = [&]() { double acc = 0.0; for (double v : part) acc += v; return acc; };
+    auto dot = [&](int l, MGVec a, MGVec b) {
+        forSections([&](int s) {
+            const MGLevel& L = secs[s].lv[l];
+            double acc = 0.0;
+            for (size_t i=0; i<L.active.size(); ++i) acc += double((L.*a)[i]) * (L.*b)[i];
+            part[s] = acc;
+        });
+        return reduce();
+    };
+
+    // Level 0: temperatures in x, heat capacity in t (until the region pass is done).
+    forSections([&](int s) {
+        MGSection& m = secs[s];
+        MGLevel& L = m.lv[0];
+        L.init(SECTION_EDGE);
+        const Section& S = *m.S;
+        mg_for_cells(SECTION_EDGE, [&](int x, int yl, int z, int i) {
+            const int c = cell_ix(x,yl,z);
+            const uint16_t mat = S.matIx.get(c);
+            L.x[i]  = temp_decode(S.T_curr[c]);
+            L.kx[i] = S.kx[c]; L.ky[i] = S.ky[c]; L.kz[i] = S.kz[c];
+            if (mat == m.C->void_ix) return;
+            L.t[i] = std::max(1e-8f, S.mass_kg[c] * world.materials.byIx(mat).heatCapacity);
+            L.active[i] = !(cfg.pinned && cfg.pinned(*m.C, x, m.sy * SECTION_EDGE + yl, z));
+        });
+    });
+
+    // Regions connected through k > 0 faces; one without a fixed neighbor becomes fixed at its mean.
+    {
+        std::vector<uint8_t> seen(size_t(n) * SECTION_N, 0);
+        std::vector<int> stack, members;
+        for (int g0=0; g0<n*SECTION_N; ++g0) {
+            if (seen[g0] || !secs[g0 / SECTION_N].lv[0].active[g0 % SECTION_N]) continue;
+            bool anchored = false;
+            double CT = 0.0, Csum = 0.0;
+            members.clear();
+            stack.assign(1, g0);
+            seen[g0] = 1;
+            while (!stack.empty()) {
+                const int g = stack.back(); stack.pop_back();
+                members.push_back(g);
+                const int s = g / SECTION_N, i = g % SECTION_N;
+                const MGLevel& L = secs[s].lv[0];
+                CT += double(L.t[i]) * L.x[i]; Csum += L.t[i];
+                const int x = i % SECTION_EDGE, z = (i / SECTION_EDGE) % SECTION_EDGE, y = i / (SECTION_EDGE * SECTION_EDGE);
+                mg_cell_faces(secs, s, 0, x, y, z, [&](int, float k, int sj, int j) {
+                    if (k == 0.0f) return;
+                    if (!secs[sj].lv[0].active[j]) { anchored = true; return; }
+                    const int gj = sj * SECTION_N + j;
+                    if (!seen[gj]) { seen[gj] = 1; stack.push_back(gj); }
+                });
+            }
+            if (anchored) { st.solvedCells += members.size(); continue; }
+            const float mean = float(CT / Csum);
+            for (int g : members) {
+                MGLevel& L = secs[g / SECTION_N].lv[0];
+                L.x[g % SECTION_N] = mean;
+                L.active[g % SECTION_N] = 0;
+            }
+            st.floatingCells += members.size();
+            ++st.floatingRegions;
+        }
+    }
+
+    if (st.solvedCells > 0) {
+        for (int l=0; l+1<MG_LEVELS; ++l) forSections([&](int s) { mg_coarsen(secs, s, l); });
+        for (int l=0; l<MG_LEVELS; ++l)   forSections([&](int s) { mg_jacobi_diag(secs, s, l); });
+        forSections([&](int s) { std::fill(secs[s].lv[0].t.begin(), secs[s].lv[0].t.end(), 0.0f); });
+
+        const int last = MG_LEVELS - 1;
+        auto each = [&](int l, auto&& fn) {   // fn(level, i) over active cells of every section
+            forSections([&](int s) {
+                MGLevel& L = secs[s].lv[l];
+                for (size_t i=0; i<L.active.size(); ++i) if (L.active[i]) fn(L, i);
+            });
+        };
+        // Coarsest level (one cell per section): Jacobi-CG on u from f
+        auto coarseSolve = [&]() {
+            for (int s=0; s<n; ++s) {
+                MGLevel& G = secs[s].lv[last];
+                G.u[0] = 0.0f; G.r[0] = G.f[0]; G.t[0] = G.Dinv[0] * G.r[0]; G.p[0] = G.t[0];
+            }
+            double rz = 0.0;
+            for (int s=0; s<n; ++s) rz += double(secs[s].lv[last].r[0]) * secs[s].lv[last].t[0];
+            const double rz0 = rz;
+            for (int it=0; it<2*n+50 && rz > 1e-14 * rz0; ++it) {
+                double pq = 0.0;
+                for (int s=0; s<n; ++s) { mg_apply(secs, s, last, &MGLevel::p, &MGLevel::q); pq += double(secs[s].lv[last].p[0]) * secs[s].lv[last].q[0]; }
+                if (!(pq > 0.0)) break;
+                const float alpha = float(rz / pq);
+                double rzNew = 0.0;
+                for (int s=0; s<n; ++s) {
+                    MGLevel& G = secs[s].lv[last];
+                    G.u[0] += alpha * G.p[0]; G.r[0] -= alpha * G.q[0]; G.t[0] = G.Dinv[0] * G.r[0];
+                    rzNew += double(G.r[0]) * G.t[0];
                 }
+                const float beta = float(rzNew / rz);
+                rz = rzNew;
+                for (int s=0; s<n; ++s) { MGLevel& G = secs[s].lv[last]; G.p[0] = G.t[0] + beta * G.p[0]; }
+            }
+        };
+        auto jacobi = [&](int l) {
+            forSections([&](int s) { mg_apply(secs, s, l, &MGLevel::u, &MGLevel::t); });
+            each(l, [&](MGLevel& L, size_t i) { L.u[i] += cfg.omega * L.Dinv[i] * (L.f[i] - L.t[i]); });
+        };
+        // u ~= A_l^-1 f, starting from u = 0
+        auto vcycle = [&](auto&& self, int l) -> void {
+            if (l == last) { coarseSolve(); return; }
+            forSections([&](int s) { std::fill(secs[s].lv[l].u.begin(), secs[s].lv[l].u.end(), 0.0f); });
+            for (int k=0; k<cfg.smooth; ++k) jacobi(l);
+            forSections([&](int s) {
+                MGLevel& L = secs[s].lv[l];
+                MGLevel& G = secs[s].lv[l + 1];
+                mg_apply(secs, s, l, &MGLevel::u, &MGLevel::t);
+                std::fill(G.f.begin(), G.f.end(), 0.0f);
+                mg_for_cells(L.e, [&](int x, int y, int z, int i) {
+                    if (L.active[i]) G.f[G.ix(x/2, y/2, z/2)] += L.f[i] - L.t[i];
+                });
+            });
+            self(self, l + 1);
+            forSections([&](int s) {
+                MGLevel& L = secs[s].lv[l];
+                const MGLevel& G = secs[s].lv[l + 1];
+                mg_for_cells(L.e, [&](int x, int y, int z, int i) {
+                    if (L.active[i]) L.u[i] += G.u[G.ix(x/2, y/2, z/2)];
+                });
+            });
+            for (int k=0; k<cfg.smooth; ++k) jacobi(l);
+        };
 
-                float Tnew = Tc + (dt_seconds / Cth) * dT;
-                if      (Tnew <   0.0f) Tnew = 0.0f;
-                else if (Tnew > 6000.0f) Tnew = 6000.0f;
-                C.T_next[i] = Tnew;
+        // Outer CG on level 0: r = -A x with the fixed cells at their temperature, z = V(r)
+        auto residual = [&]() {
+            forSections([&](int s) { mg_apply(secs, s, 0, &MGLevel::x, &MGLevel::r); });
+            each(0, [](MGLevel& L, size_t i) { L.r[i] = -L.r[i]; });
+        };
+        auto precondition = [&]() {
+            each(0, [](MGLevel& L, size_t i) { L.f[i] = L.r[i]; });
+            vcycle(vcycle, 0);
+        };
+        residual();
+        double rr = dot(0, &MGLevel::r, &MGLevel::r);
+        st.residual0 = std::sqrt(rr);
+        precondition();
+        each(0, [](MGLevel& L, size_t i) { L.p[i] = L.u[i]; });
+        double rz = dot(0, &MGLevel::r, &MGLevel::u);
+        const double stop = cfg.tolerance * cfg.tolerance * rr;
+        while (st.iterations < cfg.maxIters && rr > stop) {
+            forSections([&](int s) { mg_apply(secs, s, 0, &MGLevel::p, &MGLevel::q); });
+            const double pq = dot(0, &MGLevel::p, &MGLevel::q);
+            if (!(pq > 0.0)) break;
+            const float alpha = float(rz / pq);
+            each(0, [&](MGLevel& L, size_t i) { L.x[i] += alpha * L.p[i]; L.r[i] -= alpha * L.q[i]; });
+            rr = dot(0, &MGLevel::r, &MGLevel::r);
+            ++st.iterations;
+            if (rr <= stop) {
+                // The recurrence drifts from the true residual: stop only if that one is below the
+                // tolerance too, else restart CG from it
+                residual();
+                rr = dot(0, &MGLevel::r, &MGLevel::r);
+                if (rr <= stop) break;
+                precondition();
+                rz = dot(0, &MGLevel::r, &MGLevel::u);
+                each(0, [](MGLevel& L, size_t i) { L.p[i] = L.u[i]; });
+                continue;
             }
+            precondition();
+            const double rzNew = dot(0, &MGLevel::r, &MGLevel::u);
+            const float beta = float(rzNew / rz);
+            rz = rzNew;
+            each(0, [&](MGLevel& L, size_t i) { L.p[i] = L.u[i] + beta * L.p[i]; });
         }
+
+        // Report the true residual, not the recurrence
+        residual();
+        st.residual = std::sqrt(dot(0, &MGLevel::r, &MGLevel::r));
+        st.converged = st.residual <= cfg.tolerance * st.residual0;
+        for (const MGSection& m : secs)
+            for (float v : m.lv[0].r) st.maxResidual = std::max(st.maxResidual, double(std::fabs(v)));
+    }
+
+    forSections([&](int s) {
+        const MGSection& m = secs[s];
+        const MGLevel& L = m.lv[0];
+        Section& S = *m.S;
+        temp_t* Tc = S.T_curr.writable();
+        temp_t* Tn = S.T_next.empty() ? nullptr : S.T_next.writable();
+        mg_for_cells(SECTION_EDGE, [&](int x, int yl, int z, int i) {
+            const int c = cell_ix(x,yl,z);
+            if (S.matIx.get(c) == m.C->void_ix) return;
+            Tc[c] = temp_encode(std::min(std::max(L.x[i], 0.0f), SIM_T_MAX));
+            if (Tn) Tn[c] = Tc[c];
+        });
+    });
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        C.asleep.fill(0);
+        C.calmFrames.fill(0);
+        recomputeSectionLoaded(C);
+    }
+    return st;
+}
+
+// ====== Multi-rate stepping (SimSolver::MultiRate) ======
+// The explicit step keeps every cell between its neighbors while dtC * sum(k) <= 1. Each dense
+// section takes n = 2^m substeps of dt/n per frame: the smallest power of two that brings its
+// largest dtC * sum(k) to <= 1, clamped to multirate.maxSubsteps. Every section steps at the end
+// of its own dt/n intervals on a common clock of dt/L (L = largest n). Faces between sections
+// of different rates are evaluated only by the finer side, against the coarse side's T, which
+// stays frozen over the coarse interval. The finer side deposits the same flux, scaled to the
+// coarse step, into a register that the coarse side reads in place of that face. Both sides see
+// the same energy, so the exchange is conservative (up to the [0, 6000] clamp, as in Explicit).
+constexpr int MULTIRATE_MAX_SUBSTEPS = 128;   // Chunk::substeps is a uint8_t
+constexpr int SECTION_FACE_N = SECTION_EDGE * SECTION_EDGE;
+
+// Largest dtC * sum(k) over the non-void cells of a dense section (coefficients must be current).
+inline float section_stability_number(const World& world, const Chunk& C, int sy) {
+    const Section& S = *C.section(sy);
+    const SectionNeighbors nb = resolve_section_neighbors(world, C, sy);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    float worst = 0.0f;
+    for_each_section_row(sy, [&](int y, int z) {
+        const SectionRowNeighbors r = section_row_neighbors(S, nb, y, z);
+        const int base = cell_ix(0,y,z);
+        uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+        const float* KX = S.kx.data() + base;
+        for (int x=0; x<CHUNK_W; ++x) {
+            if (anyVoid && M[x] == C.void_ix) continue;
+            const float sumK = KX[x] + (x > 0 ? KX[x-1] : r.Kxn) + r.Kyp[x] + r.Kym[x] + r.Kzp[x] + r.Kzm[x];
+            worst = std::max(worst, S.dtC[base + x] * sumK);
+        }
+    });
+    return worst;
+}
+inline int section_substeps(const World& world, const Chunk& C, int sy) {
+    const float s = section_stability_number(world, C, sy);
+    const int cap = std::clamp(world.multirate.maxSubsteps, 1, MULTIRATE_MAX_SUBSTEPS);
+    int n = 1;
+    while (n < cap && float(n) < s) n *= 2;
+    return n;
+}
+
+// One section with its rate and its face neighbors (xn, xp, yn, yp, zn, zp; opposite face = f^1).
+struct MultiRateSection {
+    Chunk* C; int sy; int n;
+    int nb[6];                 // task index, -1 = air / missing chunk / world edge
+    float* reg;                // SECTION_FACE_N per face toward a finer neighbor, else nullptr
+    float maxDelta;
+    double ms;
+};
+// Face-plane index of a boundary cell: x faces [y][z], y faces [z][x], z faces [y][x].
+inline int multirate_face_cell(int f, int x, int yl, int z) {
+    return f < 2 ? yl*SECTION_EDGE + z : f < 4 ? z*SECTION_EDGE + x : yl*SECTION_EDGE + x;
+}
+
+// One substep of dt/n for section t: the scalar kernel plus the face rules above.
+inline float multirate_substep(const World& world, std::vector<MultiRateSection>& secs, int t) {
+    MultiRateSection& m = secs[t];
+    Chunk& C = *m.C;
+    Section& S = *C.section(m.sy);
+    const SectionNeighbors nb = resolve_section_neighbors(world, C, m.sy);
+    const bool anyVoid = S.matIx.contains(C.void_ix);
+    const float scale = 1.0f / float(m.n);         // exact: n is a power of two
+    bool finer[6], coarser[6];
+    float* out[6];                                 // coarser neighbor's register for the shared face
+    float ratio[6];                                // coarse / fine substep count
+    for (int f=0; f<6; ++f) {
+        const int j = m.nb[f];
+        finer[f]   = j >= 0 && secs[j].n > m.n;
+        coarser[f] = j >= 0 && secs[j].n < m.n;
+        out[f]     = coarser[f] ? secs[j].reg + (f^1) * SECTION_FACE_N : nullptr;
+        ratio[f]   = coarser[f] ? float(secs[j].n) / float(m.n) : 0.0f;
     }
+    float maxDelta = 0.0f;
+    temp_t* Tnext = S.T_next.writable(false);  // every cell is written below
+
+    for_each_section_row(m.sy, [&](int y, int z) {
+        const SectionRowNeighbors r = section_row_neighbors(S, nb, y, z);
+        const int base = cell_ix(0,y,z), yl = y & (SECTION_EDGE-1);
+        uint16_t M[CHUNK_W];
+        if (anyVoid) S.matIx.decode_row(base, M);
+        const temp_t* T   = S.T_curr.data() + base;
+        const float*  KX  = S.kx.data()     + base;
+        const float*  DTC = S.dtC.data()    + base;
+        temp_t*       Tn  = Tnext + base;
+        // boundary face of this cell in direction f (or -1 for an interior face)
+        const int fy = yl == 0 ? 2 : yl == SECTION_EDGE-1 ? 3 : -1;
+        const int fz = z  == 0 ? 4 : z  == CHUNK_D-1      ? 5 : -1;
+
+        for (int x=0; x<CHUNK_W; ++x) {
+            if (anyVoid && M[x] == C.void_ix) { Tn[x] = T[x]; continue; }
+
+            const float Tc  = temp_decode(T[x]);
+            const float Txp = (x + 1 < CHUNK_W) ? temp_decode(T[x+1]) : r.Txp;
+            const float Txn = (x > 0)           ? temp_decode(T[x-1]) : r.Txn;
+            const float Kxn = (x > 0)           ? KX[x-1] : r.Kxn;
+            auto face = [&](int f, float k, float Tnb) {
+                if (f < 0) return k * (Tnb - Tc);
+                const int c = multirate_face_cell(f, x, yl, z);
+                if (finer[f]) return m.reg[f * SECTION_FACE_N + c];
+                const float q = k * (Tnb - Tc);
+                if (coarser[f]) out[f][c] -= q * ratio[f];
+                return q;
+            };
+
+            float dT = 0.0f;
+            dT += face(x == CHUNK_W-1 ? 1 : -1, KX[x], Txp);
+            dT += face(x == 0         ? 0 : -1, Kxn,   Txn);
+            dT += face(fy == 3 ? 3 : -1, r.Kyp[x], temp_decode(r.Typ[x]));
+            dT += face(fy == 2 ? 2 : -1, r.Kym[x], temp_decode(r.Tym[x]));
+            dT += face(fz == 5 ? 5 : -1, r.Kzp[x], temp_decode(r.Tzp[x]));
+            dT += face(fz == 4 ? 4 : -1, r.Kzm[x], temp_decode(r.Tzm[x]));
+
+            float Tnew = Tc + (DTC[x] * scale) * dT;
+            if      (Tnew <   0.0f) Tnew = 0.0f;
+            else if (Tnew > 6000.0f) Tnew = 6000.0f;
+            Tn[x] = temp_encode(Tnew);
+            maxDelta = std::max(maxDelta, std::fabs(Tnew - Tc));
+        }
+    });
+    // the registers read this substep start over for the next coarse interval
+    for (int f=0; f<6; ++f)
+        if (finer[f]) std::fill_n(m.reg + f * SECTION_FACE_N, SECTION_FACE_N, 0.0f);
+    return maxDelta;
+}
+
+// Runs the frame as MultiRate and leaves the result in T_next (every loaded section, ranLast = 1).
+// Called after the frame's uniform promotion, sleep update and coefficient refresh. Returns false
+// without touching any temperature when every dense section needs a single substep; the caller
+// then runs the plain explicit frame (with its uniform and sleep shortcuts). Otherwise every
+// loaded section is made dense (heat crosses up to n cells per frame) and sleep is cleared, as
+// in ImplicitPCG.
+inline bool multirate_frame_to_backbuffers(World& world, float dt_seconds, SimWorkerPool* pool) {
+    using clock = std::chrono::steady_clock;
+    using nsec  = std::chrono::nanoseconds;
+    MultiRateWorkspace& ws = world.multirateWork;
+
+    auto refreshSubsteps = [&] {
+        int maxN = 1;
+        auto& stale = ws.stale;
+        stale.clear();
+        for (auto& kv : world.chunks) {
+            Chunk& C = *kv.second;
+            for (int sy=0; sy<SECTIONS_Y; ++sy) {
+                const Section* S = C.section(sy);
+                if (!S || !S->dense) continue;
+                if (!C.substeps[sy]) stale.emplace_back(&C, sy);
+                else                 maxN = std::max<int>(maxN, C.substeps[sy]);
+            }
+        }
+        auto run = [&](int t) { stale[t].first->substeps[stale[t].second] = (uint8_t)section_substeps(world, *stale[t].first, stale[t].second); };
+        if (pool) pool->run((int)stale.size(), run);
+        else      for (int t=0; t<(int)stale.size(); ++t) run(t);
+        for (auto& [C, sy] : stale) maxN = std::max<int>(maxN, C->substeps[sy]);
+        return maxN;
+    };
+
+    if (refreshSubsteps() == 1) {
+        world.multirateLast = MultiRateStats{};
+        return false;
+    }
+
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            Section* S = C.section(sy);
+            if (S && !S->dense) { S->make_dense(); C.coeffDirty[sy] = 1; }
+        }
+    }
+    refresh_dirty_coeffs(world, dt_seconds);
+    const int L = refreshSubsteps();
+
+    // sections, their neighbors and the registers of faces toward finer neighbors
+    std::vector<MultiRateSection>& secs = ws.secs;
+    auto rateOf = [](const Chunk& C, int sy) { return C.section(sy) ? int(C.substeps[sy]) : 0; };
+    bool rebuild = ws.chunkEpoch != world.chunkEpoch;
+    for (auto& kv : world.chunks) {
+        if (rebuild) break;
+        const Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y && !rebuild; ++sy) rebuild = secs[C.multirateBase + sy].n != rateOf(C, sy);
+    }
+    if (rebuild) {
+        secs.clear();
+        for (auto& kv : world.chunks) {
+            Chunk& C = *kv.second;
+            C.multirateBase = (int)secs.size();
+            for (int sy=0; sy<SECTIONS_Y; ++sy)
+                secs.push_back(MultiRateSection{&C, sy, rateOf(C, sy), {}, nullptr, 0.0f, 0.0});
+        }
+        auto indexOf = [](const Chunk* N, int sy) {
+            if (!N || sy < 0 || sy >= SECTIONS_Y || !N->section(sy)) return -1;
+            return N->multirateBase + sy;
+        };
+        for (auto& m : secs) {
+            if (!m.n) continue;
+            const Chunk& C = *m.C;
+            m.nb[0] = indexOf(C.xn, m.sy);
+            m.nb[1] = indexOf(C.xp, m.sy);
+            m.nb[2] = indexOf(&C, m.sy - 1);
+            m.nb[3] = indexOf(&C, m.sy + 1);
+            m.nb[4] = indexOf(C.zn, m.sy);
+            m.nb[5] = indexOf(C.zp, m.sy);
+        }
+        auto hasFiner = [&](const MultiRateSection& m) {
+            for (int f=0; f<6; ++f)
+                if (m.n && m.nb[f] >= 0 && secs[m.nb[f]].n > m.n) return true;
+            return false;
+        };
+        size_t regFaces = 0;
+        for (auto& m : secs) if (hasFiner(m)) regFaces += 6;
+        ws.regs.assign(regFaces * SECTION_FACE_N, 0.0f);
+        for (auto& list : ws.byRate) list.clear();
+        for (size_t t=0, at=0; t<secs.size(); ++t) {
+            MultiRateSection& m = secs[t];
+            if (!m.n) continue;
+            int k = 0;
+            while ((1 << k) < m.n) ++k;
+            ws.byRate[k].push_back((int)t);
+            if (hasFiner(m)) { m.reg = ws.regs.data() + at; at += 6 * SECTION_FACE_N; }
+        }
+        ws.chunkEpoch = world.chunkEpoch;
+    }
+    for (auto& m : secs) { m.maxDelta = 0.0f; m.ms = 0.0; }
+
+    // Clock of dt/L: at tick j a section of rate n steps when (j+1) % (L/n) == 0. Finer rates go
+    // first so their deposits are in before the coarse side reads them; swaps wait for the tick end.
+    // The last tick (every section steps) stays in T_next for swap_all_backbuffers.
+    int levels = 0;
+    while ((1 << levels) < L) ++levels;
+    size_t sectionSteps = 0;
+    for (int j=0; j<L; ++j) {
+        for (int k=levels; k>=0; --k) {
+            if ((j + 1) % (L >> k)) continue;
+            const std::vector<int>& batch = ws.byRate[k];
+            auto run = [&](int b) {
+                MultiRateSection& m = secs[batch[b]];
+                auto s0 = clock::now();
+                m.maxDelta = std::max(m.maxDelta, multirate_substep(world, secs, batch[b]));
+                m.ms += std::chrono::duration_cast<nsec>(clock::now() - s0).count() / 1'000'000.0;
+            };
+            if (pool) pool->run((int)batch.size(), run);
+            else      for (int b=0; b<(int)batch.size(); ++b) run(b);
+            sectionSteps += batch.size();
+        }
+        if (j + 1 < L)
+            for (int k=levels; k>=0; --k) {
+                if ((j + 1) % (L >> k)) continue;
+                for (int t : ws.byRate[k]) { Section& S = *secs[t].C->section(secs[t].sy); std::swap(S.T_curr, S.T_next); }
+            }
+    }
+
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        C.chunk_ms_last = 0.0;
+        C.asleep.fill(0);
+        C.calmFrames.fill(0);
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const MultiRateSection& m = secs[C.multirateBase + sy];
+            C.ranLast[sy] = m.n > 0;
+            C.maxDelta[sy] = m.maxDelta;
+            C.section_ms_last[sy] = m.ms;
+            C.chunk_ms_last += m.ms;
+        }
+    }
+    world.multirateLast = MultiRateStats{L, sectionSteps};
+    return true;
+}
+
+// ====== In-place Jacobi (World::inPlace) ======
+// A section's kernel writes a one-section scratch on the worker's stack. The interior goes straight
+// back to T_curr; the shell (planes y=0 / y=15 and the x/z border of the rows between, i.e. every
+// cell a neighbor section reads) is parked until all sections ran, so every kernel still sees the
+// old frame and the result is bitwise identical to the T_next path.
+// A section whose T_curr is held by a snapshot must not write it; its frame goes to a fresh T_next
+// instead and commit_section_frame swaps it in, so a published buffer is never copied here either.
+constexpr int SECTION_SHELL_N = 2*CHUNK_D*CHUNK_W + (SECTION_EDGE-2)*(2*CHUNK_W + 2*(CHUNK_D-2));
+
+// f(first cell, cells) for each X-row run of the shell, in a fixed order.
+template<class F> inline void for_each_section_shell_run(F&& f) {
+    for (int yl=0; yl<SECTION_EDGE; ++yl)
+        for (int z=0; z<CHUNK_D; ++z) {
+            const int base = cell_ix(0,yl,z);
+            if (yl == 0 || yl == SECTION_EDGE-1 || z == 0 || z == CHUNK_D-1) { f(base, CHUNK_W); continue; }
+            f(base, 1);
+            f(base + CHUNK_W-1, 1);
+        }
+}
+// Interior of `next` into T_curr (not shared), shell into `shell` (SECTION_SHELL_N cells).
+inline void write_back_section_interior(Section& S, const temp_t* next, temp_t* shell) {
+    temp_t* T = S.T_curr.writable();
+    for (int yl=1; yl<SECTION_EDGE-1; ++yl)
+        for (int z=1; z<CHUNK_D-1; ++z) {
+            const int base = cell_ix(1,yl,z);
+            std::memcpy(T + base, next + base, (CHUNK_W-2) * sizeof(temp_t));
+        }
+    for_each_section_shell_run([&](int base, int n) { std::memcpy(shell, next + base, n * sizeof(temp_t)); shell += n; });
+}
+// Second pass: the parked shell into T_curr, or the staged T_next swapped in (and dropped).
+inline void commit_section_frame(Section& S, const temp_t* shell) {
+    if (!S.T_next.empty()) { std::swap(S.T_curr, S.T_next); S.T_next.clear(); return; }
+    temp_t* T = S.T_curr.writable();
+    for_each_section_shell_run([&](int base, int n) { std::memcpy(T + base, shell, n * sizeof(temp_t)); shell += n; });
 }
 
 // ====== Frame functions (compute without lock, swap with O(1) under lock) ======
-inline void compute_frame_to_backbuffers(World& world, float dt_seconds) {
+// One task per awake dense (chunk, sy) section; static uniform and sleeping sections cost nothing
+// and are not swapped. Tasks only write their own T_next and read T_curr/coefficients, so the
+// result is bitwise identical for any pool size (Jacobi update).
+// With world.solver == ImplicitPCG every loaded section is made dense and advanced by one
+// backward-Euler solve instead (no sleeping); the solve time is spread evenly over the sections.
+// With MultiRate the frame is substepped per section (multirate_frame_to_backbuffers) once any
+// section needs more than one substep.
+// Explicit with world.inPlace writes T_curr directly (see write_back_section_interior), with a short
+// shell commit pass after the sections; results are those of the T_next path.
+// world.haloExchange adds a halo exchange pass before the kernels (see SectionHalo); without it
+// the kernels read their x/z neighbors through the chunk links and stale halos are dropped.
+inline void compute_frame_to_backbuffers(World& world, float dt_seconds, SimWorkerPool* pool = nullptr) {
     using clock = std::chrono::steady_clock;
     using nsec  = std::chrono::nanoseconds;
 
+    auto msSince = [](clock::time_point t) { return std::chrono::duration_cast<nsec>(clock::now() - t).count() / 1'000'000.0; };
+    const auto f0 = clock::now();
+    world.phaseLast = FramePhaseTimes{};
+
+    if (world.solver == SimSolver::ImplicitPCG) {
+        auto s0 = clock::now();
+        size_t sections = 0;
+        for (auto& kv : world.chunks) {
+            Chunk& C = *kv.second;
+            for (int sy=0; sy<SECTIONS_Y; ++sy) {
+                Section* S = C.section(sy);
+                C.asleep[sy] = 0; C.calmFrames[sy] = 0;
+                C.ranLast[sy] = (S != nullptr);
+                if (!S) continue;
+                ++sections;
+                if (!S->dense) { S->make_dense(); C.coeffDirty[sy] = 1; }
+            }
+        }
+        sync_back_buffers(world);
+        refresh_dirty_coeffs(world, dt_seconds);
+        world.phaseLast.prepareMs = msSince(f0);
+        const auto k0 = clock::now();
+        world.implicitLast = implicit_solve_to_backbuffers(world, pool);
+        world.phaseLast.kernelMs = msSince(k0);
+        const double per = sections ? std::chrono::duration_cast<nsec>(clock::now() - s0).count() / 1'000'000.0 / sections : 0.0;
+        for (auto& kv : world.chunks) {
+            Chunk& C = *kv.second;
+            C.chunk_ms_last = 0.0;
+            for (int sy=0; sy<SECTIONS_Y; ++sy) {
+                C.section_ms_last[sy] = C.ranLast[sy] ? per : 0.0;
+                C.chunk_ms_last += C.section_ms_last[sy];
+            }
+        }
+        return;
+    }
+
+    promote_uniform_sections(world);
+    sync_back_buffers(world);
+    update_section_sleep(world, dt_seconds);
+    refresh_dirty_coeffs(world, dt_seconds);
+    if (world.solver == SimSolver::MultiRate) {
+        world.phaseLast.prepareMs = msSince(f0);
+        const auto k0 = clock::now();
+        const bool done = multirate_frame_to_backbuffers(world, dt_seconds, pool);
+        world.phaseLast.kernelMs = msSince(k0);
+        if (done) return;
+        world.phaseLast.kernelMs = 0.0;
+    }
+
+    const bool halo = world.haloExchange;
+    struct SectionTask { Chunk* C; int sy; };
+    std::vector<SectionTask> tasks;
     for (auto& kv : world.chunks) {
         Chunk& C = *kv.second;
         C.chunk_ms_last = 0.0;
         C.section_ms_last.fill(0.0);
-
         for (int sy=0; sy<SECTIONS_Y; ++sy) {
-            if (!C.sectionLoaded[sy]) continue;
-            auto s0 = clock::now();
-            simulate_section_16x16x16(world, C, world.materials, sy, dt_seconds);
-            auto s1 = clock::now();
-            double ms = std::chrono::duration_cast<nsec>(s1 - s0).count() / 1'000'000.0;
-            C.section_ms_last[sy] = ms;
-            C.chunk_ms_last      += ms;
+            C.ranLast[sy] = C.sectionLoaded[sy] && C.section(sy)->dense && !C.asleep[sy];
+            if (!C.ranLast[sy]) continue;
+            tasks.push_back(SectionTask{&C, sy});
+            if (!halo && C.section(sy)->halo) C.section(sy)->halo.reset();
         }
-        // NOTE: no swap here; we only filled T_next
+    }
+
+    // inPlace: pass 0 computes and writes back the interiors, pass 1 commits the parked shells.
+    const bool scratch = world_in_place(world);
+    if (scratch && world.shellScratch.size() < tasks.size() * SECTION_SHELL_N)
+        world.shellScratch.resize(tasks.size() * SECTION_SHELL_N);
+    temp_t* const shells = world.shellScratch.data();
+    // haloExchange: the kernel pass is preceded by a halo exchange phase (see exchange_section_halo).
+    auto exchangeTask = [&](int t) {
+        Chunk& C = *tasks[t].C;
+        const int sy = tasks[t].sy;
+        auto s0 = clock::now();
+        exchange_section_halo(world, C, sy);
+        auto s1 = clock::now();
+        C.section_ms_last[sy] += std::chrono::duration_cast<nsec>(s1 - s0).count() / 1'000'000.0;
+    };
+    auto runTask = [&](int t, int pass) {
+        Chunk& C = *tasks[t].C;
+        const int sy = tasks[t].sy;
+        auto s0 = clock::now();
+        float d = 0.0f;
+        Section& S = *C.section(sy);
+        if (!scratch)                 d = simulate_section_16x16x16(C, sy);
+        else if (pass == 1)           commit_section_frame(S, shells + size_t(t) * SECTION_SHELL_N);
+        else if (S.T_curr.shared())   d = simulate_section_16x16x16(C, sy);  // staged in T_next
+        else {
+            alignas(64) temp_t next[SECTION_N];
+            d = simulate_section_16x16x16(C, sy, next);
+            write_back_section_interior(S, next, shells + size_t(t) * SECTION_SHELL_N);
+        }
+        auto s1 = clock::now();
+        C.maxDelta[sy] = pass ? std::max(C.maxDelta[sy], d) : d;
+        C.section_ms_last[sy] += std::chrono::duration_cast<nsec>(s1 - s0).count() / 1'000'000.0;
+    };
+    world.phaseLast.prepareMs = msSince(f0);   // multi-rate fallback: includes its attempt
+    for (int pass=0; pass < (scratch ? 2 : 1); ++pass) {
+        if (pass == 0 && halo) {
+            const auto h0 = clock::now();
+            if (pool) pool->run((int)tasks.size(), exchangeTask);
+            else      for (int t=0; t<(int)tasks.size(); ++t) exchangeTask(t);
+            world.phaseLast.haloMs += msSince(h0);
+        }
+        const auto k0 = clock::now();
+        if (pool) pool->run((int)tasks.size(), [&](int t) { runTask(t, pass); });
+        else      for (int t=0; t<(int)tasks.size(); ++t) runTask(t, pass);
+        world.phaseLast.kernelMs += msSince(k0);
+    }
+
+    // NOTE: no swap here; we only filled T_next (or T_curr in place)
+    for (auto& kv : world.chunks) {
+        Chunk& C = *kv.second;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) C.chunk_ms_last += C.section_ms_last[sy];
     }
 }
 
 inline void swap_all_backbuffers(World& world) {
     for (auto& kv : world.chunks) {
         Chunk& C = *kv.second;
-        std::swap(C.T_curr, C.T_next); // O(1) vector swap
+        for (int sy=0; sy<SECTIONS_Y; ++sy)
+            if (C.ranLast[sy] && !C.section(sy)->T_next.empty())  // in-place sections have no back buffer
+                std::swap(C.section(sy)->T_curr, C.section(sy)->T_next); // O(1) buffer swap
     }
 }
 
 // Legacy combined step (kept for single-threaded callers if you ever need it):
-inline void step_frame(World& world, float dt_seconds) {
-    compute_frame_to_backbuffers(world, dt_seconds);
+inline void step_frame(World& world, float dt_seconds, SimWorkerPool* pool = nullptr) {
+    compute_frame_to_backbuffers(world, dt_seconds, pool);
     swap_all_backbuffers(world);
 }
 
 // ====== Fill one entire 16x16x16 section ======
 // NOTE: now needs mats to set per-voxel mass to material.defaultMass when unspecified.
+// The result is a uniform section (see Section); filling with void releases the section.
 inline void fill_section_with(Chunk& C, uint16_t mat_ix, float T, int sy, const MaterialLUT& mats) {
     if (sy < 0 || sy >= SECTIONS_Y) return;
-    const float mdef = mats.byIx(mat_ix).defaultMass;
-    const int y0 = sy * SECTION_EDGE;
-    const int y1 = y0 + SECTION_EDGE;
-    for (int z = 0; z < CHUNK_D; ++z) {
-        for (int y = y0; y < y1; ++y) {
-            for (int x = 0; x < CHUNK_W; ++x) {
-                const int i = idx(x,y,z);
-                C.matIx[i]   = mat_ix;
-                C.T_curr[i]  = T;
-                C.T_next[i]  = T;
-                C.mass_kg[i] = (mat_ix == C.void_ix) ? 0.0f : mdef;
-            }
-        }
-    }
-    markSectionLoaded(C, sy, (mat_ix != C.void_ix));
+    if (mat_ix == C.void_ix) { releaseSection(C, sy); return; }
+
+    allocSection(C, sy, /*dense=*/false).make_uniform(mat_ix, temp_encode(T), mats.byIx(mat_ix).defaultMass);
+    markSectionCoeffsDirty(C, sy);
+}
+
+// ====== Single-cell edit (UI painting, network set_state) ======
+// Mass defaults to the material's defaultMass. Allocates the section for a non-void cell and
+// releases it when its last non-void cell is cleared; a uniform section is made dense first.
+inline void set_cell(Chunk& C, int x, int y, int z, uint16_t mat_ix, float T, const MaterialLUT& mats) {
+    if (x < 0 || x >= CHUNK_W || y < 0 || y >= CHUNK_H || z < 0 || z >= CHUNK_D) return;
+    const int sy = y / SECTION_EDGE;
+    const bool toVoid = (mat_ix == C.void_ix);
+    if (toVoid && !C.section(sy)) return;
+
+    Section& S = allocSection(C, sy);
+    S.make_dense();
+    const int i = cell_ix(x,y,z);
+    S.nonVoid += (toVoid ? 0 : 1) - (S.matIx.get(i) == C.void_ix ? 0 : 1);
+    S.matIx.set(i, mat_ix);
+    S.T_curr.writable()[i] = temp_encode(T);
+    if (!S.T_next.empty()) S.T_next.writable()[i] = S.T_curr[i];
+    S.mass_kg[i] = toVoid ? 0.0f : mats.byIx(mat_ix).defaultMass;
+    markSectionCoeffsDirty(C, sy);
+    if (S.nonVoid == 0) releaseSection(C, sy);
+}
+
+// Temperature-only edit; void cells and missing sections are left alone. Marks the section
+// edited so it wakes (its coefficients are rebuilt as well).
+inline void set_cell_temperature(Chunk& C, int x, int y, int z, float T) {
+    if (x < 0 || x >= CHUNK_W || y < 0 || y >= CHUNK_H || z < 0 || z >= CHUNK_D) return;
+    const int sy = y / SECTION_EDGE;
+    Section* S = C.section(sy);
+    const int i = cell_ix(x,y,z);
+    if (!S || S->matIx.get(i) == C.void_ix) return;
+
+    S->make_dense();
+    S->T_curr.writable()[i] = temp_encode(T);
+    if (!S->T_next.empty()) S->T_next.writable()[i] = S->T_curr[i];
+    markSectionCoeffsDirty(C, sy);
 }
 
 // Sum of per-chunk elapsed ms from the most recent frame.
@@ -268,4 +2676,4 @@ inline double world_total_ms_last(const World& world) {
     double total = 0.0;
     for (const auto& kv : world.chunks) total += kv.second->chunk_ms_last;
     return total;
-}
\ No newline at end of file
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <algorithm>
+#include <SDL3/SDL_cpuinfo.h>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+// Logical CPUs this process may run on (its affinity mask: containers, cpusets, taskset), in
+// ascending order; empty when unknown.
+inline std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(_WIN32)
+    DWORD_PTR proc = 0, sys = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &proc, &sys))
+        for (int c=0; c<int(sizeof(DWORD_PTR) * 8); ++c) if (proc & (DWORD_PTR(1) << c)) cpus.push_back(c);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c=0; c<CPU_SETSIZE; ++c) if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+    return cpus;
+}
+
+// Pin the calling thread to one logical CPU (best effort; no-op where unsupported).
+inline void pin_current_thread_to_cpu(int cpu) {
+#if defined(_WIN32)
+    if (cpu < 64) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// Persistent worker pool for per-frame section tasks.
+// run() splits [0, count) into one contiguous range per worker (neighboring tasks stay on one
+// core); a worker that drains its own range steals single tasks from the back of the others.
+// The calling thread participates as worker 0, so a pool of size 1 is plain serial execution.
+// threads <= 0: one worker per CPU in the process affinity mask. Pinning is opt-in: worker w goes
+// to the w-th allowed CPU (the caller keeps its own affinity); two pinned pools in one process
+// share cores, so pin only the pool that owns the machine.
+class SimWorkerPool {
+public:
+    explicit SimWorkerPool(int threads = 0, bool pin = false) {
+        const std::vector<int> cpus = allowed_cpus();
+        if (threads <= 0) threads = cpus.empty() ? std::max(1, SDL_GetNumLogicalCPUCores()) : (int)cpus.size();
+        ranges = std::make_unique<Range[]>(threads);
+        nThreads = threads;
+        for (int w=1; w<threads; ++w) {
+            const int cpu = (pin && w < (int)cpus.size()) ? cpus[w] : -1;
+            workers.emplace_back([this, w, cpu]{
+                if (cpu >= 0) pin_current_thread_to_cpu(cpu);
+                workerLoop(w);
+            });
+        }
+    }
+    ~SimWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) if (t.joinable()) t.join();
+    }
+    SimWorkerPool(const SimWorkerPool&) = delete;
+    SimWorkerPool& operator=(const SimWorkerPool&) = delete;
+
+    int size() const noexcept { return nThreads; }
+
+    // Runs fn(task) for every task in [0, count) and returns when all have finished.
+    // Not reentrant: one run() at a time.
+    void run(int count, const std::function<void(int)>& fn) {
+        if (count <= 0) return;
+        if (nThreads == 1) { for (int t=0; t<count; ++t) fn(t); return; }
+
+        for (int w=0; w<nThreads; ++w) {
+            const uint32_t b = uint32_t((int64_t)count *  w      / nThreads);
+            const uint32_t e = uint32_t((int64_t)count * (w + 1) / nThreads);
+            ranges[w].ht.store((uint64_t(b) << 32) | e, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lk(m);
+            job = &fn;
+            busy = nThreads - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        drain(0, fn);
+
+        std::unique_lock<std::mutex> lk(m);
+        done.wait(lk, [&]{ return busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    // Task range as packed (head << 32 | tail); owner pops at head, thieves at tail.
+    struct alignas(64) Range { std::atomic<uint64_t> ht{0}; };
+
+    static bool pop_front(Range& r, int& out) {
+        uint64_t v = r.ht.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t h = uint32_t(v >> 32), t = uint32_t(v);
+            if (h >= t) return false;
+            if (r.ht.compare_exchange_weak(v, (uint64_t(h + 1) << 32) | t, std::memory_order_acq_rel)) { out = int(h); return true; }
+        }
+    }
+    static bool pop_back(Range& r, int& out) {
+        uint64_t v = r.ht.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t h = uint32_t(v >> 32), t = uint32_t(v);
+            if (h >= t) return false;
+            if (r.ht.compare_exchange_weak(v, (uint64_t(h) << 32) | (t - 1), std::memory_order_acq_rel)) { out = int(t - 1); return true; }
+        }
+    }
+
+    void drain(int self, const std::function<void(int)>& fn) {
+        int task;
+        while (pop_front(ranges[self], task)) fn(task);
+        for (int k=1; k<nThreads; ++k) {
+            Range& victim = ranges[(self + k) % nThreads];
+            while (pop_back(victim, task)) fn(task);
+        }
+    }
+
+    void workerLoop(int self) {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(int)>* fn = nullptr;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk, [&]{ return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+                fn = job;
+            }
+            drain(self, *fn);
+            {
+                std::lock_guard<std::mutex> lk(m);
+                if (--busy == 0) done.notify_one();
+            }
+        }
+    }
+
+    int nThreads = 1;
+    std::unique_ptr<Range[]> ranges;
+    std::vector<std::thread> workers;
+
+    std::mutex m;
+    std::condition_variable wake, done;
+    const std::function<void(int)>* job = nullptr;
+    uint64_t generation = 0;
+    int  busy = 0;
+    bool quit = false;
+};
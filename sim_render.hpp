@@ -75,45 +75,81 @@ static inline void drawTextCentered(SDL_Renderer* r, TTF_Font* f, const std::str
 }
 
 // ---------- Helpers ----------
-static inline std::optional<std::pair<float,float>> chunk_minmax_nonvoid(const Chunk& C) {
+// Work on a live Chunk or a ChunkSnapshot (same read interface).
+template<class ChunkT>
+static inline std::optional<std::pair<float,float>> chunk_minmax_nonvoid(const ChunkT& C) {
     const uint16_t void_ix = C.void_ix;
     float mn = std::numeric_limits<float>::max();
     float mx = std::numeric_limits<float>::lowest();
     bool any=false;
-    for (int i=0;i<CHUNK_N;++i) {
-        if (C.matIx[i]==void_ix) continue;
-        float v = C.T_curr[i];
-        mn = std::min(mn, v);
-        mx = std::max(mx, v);
-        any=true;
+    for (int sy=0;sy<SECTIONS_Y;++sy) {
+        const auto* S = C.section(sy);
+        if (!S) continue; // air section
+        if (!S->dense) {  // uniform: one non-void material, one temperature
+            float v = temp_decode(S->T_row(0)[0]);
+            mn = std::min(mn, v);
+            mx = std::max(mx, v);
+            any=true;
+            continue;
+        }
+        uint16_t M[CHUNK_W];
+        for (int base=0;base<SECTION_N;base+=CHUNK_W) {
+            S->matIx.decode_row(base, M);
+            for (int x=0;x<CHUNK_W;++x) {
+                if (M[x]==void_ix) continue;
+                float v = temp_decode(S->T_row(base)[x]);
+                mn = std::min(mn, v);
+                mx = std::max(mx, v);
+                any=true;
+            }
+        }
     }
     if (!any) return std::nullopt;
     return std::make_pair(mn,mx);
 }
-static inline std::optional<float> chunk_avg_nonvoid(const Chunk& C) {
+template<class ChunkT>
+static inline std::optional<float> chunk_avg_nonvoid(const ChunkT& C) {
     const uint16_t void_ix = C.void_ix;
     double sum = 0.0;
     size_t cnt = 0;
-    for (int i=0;i<CHUNK_N;++i) {
-        if (C.matIx[i]==void_ix) continue;
-        sum += C.T_curr[i];
-        ++cnt;
+    for (int sy=0;sy<SECTIONS_Y;++sy) {
+        const auto* S = C.section(sy);
+        if (!S) continue;
+        if (!S->dense) { sum += (double)temp_decode(S->T_row(0)[0]) * SECTION_N; cnt += SECTION_N; continue; }
+        uint16_t M[CHUNK_W];
+        for (int base=0;base<SECTION_N;base+=CHUNK_W) {
+            S->matIx.decode_row(base, M);
+            for (int x=0;x<CHUNK_W;++x) {
+                if (M[x]==void_ix) continue;
+                sum += temp_decode(S->T_row(base)[x]);
+                ++cnt;
+            }
+        }
     }
     if (!cnt) return std::nullopt;
     return static_cast<float>(sum / (double)cnt);
 }
-static inline std::pair<float,float> slice_minmax_nonvoid(const Chunk& C, int z) {
+template<class ChunkT>
+static inline std::pair<float,float> slice_minmax_nonvoid(const ChunkT& C, int z) {
     const uint16_t void_ix = C.void_ix;
     float mn = std::numeric_limits<float>::max();
     float mx = std::numeric_limits<float>::lowest();
     bool any=false;
-    const int base = z * CHUNK_W * CHUNK_H;
-    for (int i=0;i<CHUNK_W*CHUNK_H;++i) {
-        if (C.matIx[base+i]==void_ix) continue;
-        float v = C.T_curr[base+i];
-        mn = std::min(mn, v);
-        mx = std::max(mx, v);
-        any=true;
+    for (int sy=0;sy<SECTIONS_Y;++sy) {
+        const auto* S = C.section(sy);
+        if (!S) continue;
+        uint16_t M[CHUNK_W];
+        for (int y=sy*SECTION_EDGE;y<(sy+1)*SECTION_EDGE;++y) {
+            const int base = cell_ix(0,y,z);
+            S->matIx.decode_row(base, M);
+            for (int x=0;x<CHUNK_W;++x) {
+                if (M[x]==void_ix) continue;
+                float v = temp_decode(S->T_row(base)[x]);
+                mn = std::min(mn, v);
+                mx = std::max(mx, v);
+                any=true;
+            }
+        }
     }
     if (!any) return {0.f,6000.f};
     return {mn,mx};
@@ -135,21 +171,19 @@ struct WorldView {
     int focus_cx = 0, focus_cz = 0;
 };
 
-static inline void init_view_from_world(WorldView& v, const World& world) {
+static inline void init_view_from_world(WorldView& v, const WorldSnapshot& world) {
     if (world.chunks.size() <= 1) {
         v.mode = RenderMode::ChunkView;
         if (!world.chunks.empty()) {
-            auto it = world.chunks.begin();
-            v.focus_cx = it->first.cx;
-            v.focus_cz = it->first.cz;
+            v.focus_cx = world.chunks.front().cx;
+            v.focus_cz = world.chunks.front().cz;
             v.sel_cx = v.focus_cx;
             v.sel_cz = v.focus_cz;
         }
     } else {
         v.mode = RenderMode::WorldMap;
-        auto it = world.chunks.begin();
-        v.sel_cx = it->first.cx;
-        v.sel_cz = it->first.cz;
+        v.sel_cx = world.chunks.front().cx;
+        v.sel_cz = world.chunks.front().cz;
     }
 }
 static inline std::string fmt_ms(double ms) {
@@ -161,7 +195,7 @@ static inline std::string fmt_ms(double ms) {
 
 // ---------- World Map ----------
 static inline void render_world_map(SDL_Renderer* r, TTF_Font* font,
-                                    const World& world, bool paused, WorldView& v,
+                                    const WorldSnapshot& world, bool paused, WorldView& v,
                                     int winW, int winH)
 {
     const int header = v.st.headerHeight;
@@ -169,9 +203,9 @@ static inline void render_world_map(SDL_Renderer* r, TTF_Font* font,
 
     int minCX= v.sel_cx, maxCX= v.sel_cx;
     int minCZ= v.sel_cz, maxCZ= v.sel_cz;
-    for (const auto& kv : world.chunks) {
-        minCX = std::min(minCX, kv.first.cx); maxCX = std::max(maxCX, kv.first.cx);
-        minCZ = std::min(minCZ, kv.first.cz); maxCZ = std::max(maxCZ, kv.first.cz);
+    if (int x0, z0, x1, z1; world.bounds(x0, z0, x1, z1)) {
+        minCX = std::min(minCX, x0); maxCX = std::max(maxCX, x1);
+        minCZ = std::min(minCZ, z0); maxCZ = std::max(maxCZ, z1);
     }
 
     float scaleMin = 0.0f, scaleMax = 6000.0f;
@@ -179,8 +213,8 @@ static inline void render_world_map(SDL_Renderer* r, TTF_Font* font,
         float mn = std::numeric_limits<float>::max();
         float mx = std::numeric_limits<float>::lowest();
         bool any=false;
-        for (const auto& kv : world.chunks) {
-            auto mm = chunk_minmax_nonvoid(*kv.second);
+        for (const ChunkSnapshot& C : world.chunks) {
+            auto mm = chunk_minmax_nonvoid(C);
             if (!mm) continue;
             mn = std::min(mn, mm->first);
             mx = std::max(mx, mm->second);
@@ -195,59 +229,58 @@ static inline void render_world_map(SDL_Renderer* r, TTF_Font* font,
     double total_ms_all_chunks = 0.0;
     size_t chunks_with_work = 0;
 
-    for (int cz = minCZ; cz <= maxCZ; ++cz) {
-        for (int cx = minCX; cx <= maxCX; ++cx) {
-            const int ox = (cx - minCX) * tile + 10;
-            const int oy = header + (cz - minCZ) * tile + 10;
-
-            const Chunk* C = world.findChunk(cx, cz);
-            SDL_Color col{0,0,0,255};
-            if (C) {
-                auto avg = chunk_avg_nonvoid(*C);
-                if (avg) col = temperatureToColor(*avg, scaleMin, scaleMax);
-                total_ms_all_chunks += C->chunk_ms_last;
-                if (C->chunk_ms_last > 0.0) ++chunks_with_work;
-            }
-            SDL_SetRenderDrawColor(r, col.r, col.g, col.b, 255);
-            SDL_FRect rect{ (float)ox, (float)oy, (float)tile, (float)tile };
-            SDL_RenderFillRect(r, &rect);
+    world.for_each_in_range(minCX, minCZ, maxCX, maxCZ, [&](int cx, int cz, const ChunkSnapshot* C) {
+        const int ox = (cx - minCX) * tile + 10;
+        const int oy = header + (cz - minCZ) * tile + 10;
 
-            SDL_SetRenderDrawColor(r, 40,40,40,255);
-            SDL_RenderRect(r, &rect);
+        SDL_Color col{0,0,0,255};
+        if (C) {
+            auto avg = chunk_avg_nonvoid(*C);
+            if (avg) col = temperatureToColor(*avg, scaleMin, scaleMax);
+            total_ms_all_chunks += C->chunk_ms_last;
+            if (C->chunk_ms_last > 0.0) ++chunks_with_work;
+        }
+        SDL_SetRenderDrawColor(r, col.r, col.g, col.b, 255);
+        SDL_FRect rect{ (float)ox, (float)oy, (float)tile, (float)tile };
+        SDL_RenderFillRect(r, &rect);
 
-            if (cx==v.sel_cx && cz==v.sel_cz) {
-                SDL_SetRenderDrawColor(r, 255,255,255,255);
-                SDL_FRect sel{ rect.x-1, rect.y-1, rect.w+2, rect.h+2 };
-                SDL_RenderRect(r, &sel);
-            }
+        SDL_SetRenderDrawColor(r, 40,40,40,255);
+        SDL_RenderRect(r, &rect);
 
-            if (C && font) {
-                drawTextCentered(r, font, fmt_ms(C->chunk_ms_last),
-                                 rect.x + rect.w*0.5f, rect.y + rect.h*0.5f);
-            }
+        if (cx==v.sel_cx && cz==v.sel_cz) {
+            SDL_SetRenderDrawColor(r, 255,255,255,255);
+            SDL_FRect sel{ rect.x-1, rect.y-1, rect.w+2, rect.h+2 };
+            SDL_RenderRect(r, &sel);
         }
-    }
+
+        if (C && font) {
+            drawTextCentered(r, font, fmt_ms(C->chunk_ms_last),
+                             rect.x + rect.w*0.5f, rect.y + rect.h*0.5f);
+        }
+    });
 
     double avg_ms_per_chunk = (chunks_with_work ? (total_ms_all_chunks / (double)chunks_with_work) : 0.0);
 
     drawColorGradientHeader(r, winW, 0.0f, 6000.0f, v.st);
     if (font) {
-        char info[256];
+        const SectionActivity act = snapshot_activity(world);
+        char info[384];
         std::snprintf(info,sizeof(info),
-            "[WORLD] chunks=%zu  sel=(%d,%d)  frame=%d  paused=%d  | per-frame: avg/chunk=%.3f ms  total=%.3f ms  (WASD/arrows, Enter=open, Space=pause)",
-            world.chunks.size(), v.sel_cx, v.sel_cz, v.frame, paused?1:0, avg_ms_per_chunk, total_ms_all_chunks);
+            "[WORLD] chunks=%zu  sel=(%d,%d)  frame=%d  paused=%d  | per-frame: avg/chunk=%.3f ms  total=%.3f ms  sections awake=%zu asleep=%zu uniform=%zu  solver=%s (cg it=%d)  (WASD/arrows, Enter=open, Space=pause)",
+            world.chunks.size(), v.sel_cx, v.sel_cz, v.frame, paused?1:0, avg_ms_per_chunk, total_ms_all_chunks,
+            act.awake, act.asleep, act.uniform, sim_solver_name(world.solver), world.cgIterations);
         drawText(r, font, info, 10.0f, 36.0f);
     }
 }
 
 // ---------- Chunk View ----------
 static inline void render_chunk_view(SDL_Renderer* r, TTF_Font* font,
-                                     const World& world, bool paused, WorldView& v,
+                                     const WorldSnapshot& world, bool paused, WorldView& v,
                                      int winW, int winH)
 {
     const int header = v.st.headerHeight;
     const int scale  = v.st.pixelScale;
-    const Chunk* C = world.findChunk(v.focus_cx, v.focus_cz);
+    const ChunkSnapshot* C = world.find(v.focus_cx, v.focus_cz);
 
     SDL_SetRenderDrawColor(r, 0,0,0,255);
     SDL_RenderClear(r);
@@ -262,10 +295,14 @@ static inline void render_chunk_view(SDL_Renderer* r, TTF_Font* font,
     if (C) {
         const uint16_t void_ix = C->void_ix;
         for (int y = 0; y < CHUNK_H; ++y) {
+            const SectionSnapshot* S = C->section(y / SECTION_EDGE);
+            if (!S) continue; // air section stays black
+            const int base = cell_ix(0,y,v.zSlice);
+            uint16_t M[CHUNK_W];
+            S->matIx.decode_row(base, M);
             for (int x = 0; x < CHUNK_W; ++x) {
-                int i = idx(x,y,v.zSlice);
-                if (C->matIx[i]==void_ix) continue; // void stays black
-                float t = C->T_curr[i];
+                if (M[x]==void_ix) continue; // void stays black
+                float t = temp_decode(S->T_row(base)[x]);
                 SDL_Color col = temperatureToColor(t, scaleMin, scaleMax);
                 SDL_SetRenderDrawColor(r, col.r, col.g, col.b, 255);
                 SDL_FRect px = {
@@ -281,26 +318,30 @@ static inline void render_chunk_view(SDL_Renderer* r, TTF_Font* font,
         // per-frame section timing overlays
         if (font) {
             double total_ms_sections = 0.0;
-            int    loaded_count = 0;
+            int    loaded_count = 0, awake = 0, asleep = 0;
             for (int sy=0; sy<SECTIONS_Y; ++sy) {
                 if (!C->sectionLoaded[sy]) continue;
                 total_ms_sections += C->section_ms_last[sy];
                 ++loaded_count;
+                if (C->section(sy)->dense) ++(C->asleep[sy] ? asleep : awake);
             }
             double avg_ms_per_section = (loaded_count ? (total_ms_sections / (double)loaded_count) : 0.0);
 
             drawColorGradientHeader(r, winW, scaleMin, scaleMax, v.st);
-            char head[256];
+            char head[320];
             std::snprintf(head, sizeof(head),
-                "[CHUNK] (%d,%d)  z=%d  frame=%d  paused=%d  | per-frame: avg/section=%.3f ms  total sections=%.3f ms  (Up/Down slice, Esc=back, Space=pause, Shift+Click=paint all layers)",
-                v.focus_cx, v.focus_cz, v.zSlice, v.frame, paused?1:0, avg_ms_per_section, total_ms_sections);
+                "[CHUNK] (%d,%d)  z=%d  frame=%d  paused=%d  | per-frame: avg/section=%.3f ms  total sections=%.3f ms  awake=%d asleep=%d  (Up/Down slice, Esc=back, Space=pause, Shift+Click=paint all layers)",
+                v.focus_cx, v.focus_cz, v.zSlice, v.frame, paused?1:0, avg_ms_per_section, total_ms_sections, awake, asleep);
             drawText(r, font, head, 10.0f, 36.0f);
 
             const float cx = (CHUNK_W * scale) * 0.5f;
             for (int sy=0; sy<SECTIONS_Y; ++sy) {
                 if (!C->sectionLoaded[sy] && C->section_ms_last[sy] <= 0.0) continue;
                 float y_center = header + (sy*SECTION_EDGE + SECTION_EDGE*0.5f) * scale;
-                drawTextCentered(r, font, fmt_ms(C->section_ms_last[sy]), cx, y_center);
+                const bool idle = C->sectionLoaded[sy] && (!C->section(sy)->dense || C->asleep[sy]);
+                std::string label = idle ? std::string(C->asleep[sy] ? "zz" : "uni") : fmt_ms(C->section_ms_last[sy]);
+                if (!idle && world.solver == SimSolver::MultiRate && C->substeps[sy] > 1) label += " x" + std::to_string(C->substeps[sy]);
+                drawTextCentered(r, font, label, cx, y_center);
             }
             return;
         }
@@ -328,22 +369,16 @@ static inline int run_world_ui(SimServer& server) {
 
     TTF_Font* font = loadTinyFont(18);
 
-    // Snapshot world under lock to initialize view
     {
         std::unique_lock<std::mutex> lk(server.worldMutex);
-        if (server.world.materials.table.empty()) {
-            server.world.materials.add(Material{0, 0, 0, 0});                    // 0 = void
-            server.world.materials.add(Material{500.0f, 100.0f, 1000.0f, 0.05f}); // 1 = generic solid
+        if (server.world.materials.table.empty()) {   // staged: the sim thread may be computing
+            server.changes.addMaterial(Material{0, 0, 0, 0});                    // 0 = void
+            server.changes.addMaterial(Material{500.0f, 100.0f, 1000.0f, 0.05f}); // 1 = generic solid
         }
-        init_view_from_world(*(new WorldView), server.world); // dummy to pre-touch; real init below
-        recomputeAllSectionLoaded(server.world);
     }
 
     WorldView view{};
-    {
-        std::unique_lock<std::mutex> lk(server.worldMutex);
-        init_view_from_world(view, server.world);
-    }
+    if (auto snap = server.snapshot()) init_view_from_world(view, *snap);
 
     const uint16_t SOLID_IX = 1;
 
@@ -415,58 +450,46 @@ static inline int run_world_ui(SimServer& server) {
             }
         }
 
-        // Sync view frame/paused flags from server
-        view.frame = (int)server.framesSimulated.load();
+        // Draw the last published frame; holding it never blocks the sim thread
+        const std::shared_ptr<const WorldSnapshot> snap = server.snapshot();
+        view.frame = snap ? (int)snap->frame : 0;
         const bool pausedNow = server.isPaused();
 
         // Editing only in Chunk View AND when paused
+        // Edits go through the server's edit queue (applied by the sim thread); a full queue drops them.
         if (pausedNow && view.mode == RenderMode::ChunkView && (left || middle || right)) {
-            std::unique_lock<std::mutex> lk(server.worldMutex);
-            Chunk* C = server.world.findChunk(view.focus_cx, view.focus_cz);
-            if (C) {
-                int localX = mouseX / view.st.pixelScale;
-                int localY = (std::max(0, mouseY - view.st.headerHeight)) / view.st.pixelScale;
-
-                auto paint = [&](float Tval, bool allLayers){
-                    if (localX<0 || localX>=CHUNK_W || localY<0 || localY>=CHUNK_H) return;
-                    const int sy = localY / SECTION_EDGE;
-
-                    auto set_voxel = [&](int x, int y, int z){
-                        const int i = idx(x,y,z);
-                        C->T_curr[i] = Tval; C->T_next[i] = Tval;
-                        C->matIx[i] = SOLID_IX; // mark as solid => section loaded
-                        C->mass_kg[i]= server.world.materials.byIx(SOLID_IX).defaultMass;
-                    };
-
-                    if (!allLayers) {
-                        set_voxel(localX, localY, view.zSlice);
-                    } else {
-                        for (int z=0; z<CHUNK_D; ++z) set_voxel(localX, localY, z);
-                    }
-                    markSectionLoaded(*C, sy, true);
-                };
+            const int cx = view.focus_cx, cz = view.focus_cz;
+            int localX = mouseX / view.st.pixelScale;
+            int localY = (std::max(0, mouseY - view.st.headerHeight)) / view.st.pixelScale;
+
+            auto paint = [&](float Tval, bool allLayers){
+                if (localX<0 || localX>=CHUNK_W || localY<0 || localY>=CHUNK_H) return;
+
+                // mark as solid => section loaded
+                if (!allLayers) {
+                    server.pushEdit(SimEdit::setCell(cx, cz, localX, localY, view.zSlice, SOLID_IX, Tval));
+                } else {
+                    for (int z=0; z<CHUNK_D; ++z) server.pushEdit(SimEdit::setCell(cx, cz, localX, localY, z, SOLID_IX, Tval));
+                }
+            };
 
-                const bool allLayers = view.shift;
-                if (left)   paint(0.0f,   allLayers);
-                if (middle) paint(300.0f, allLayers);
-                if (right)  paint(6000.0f,allLayers);
-            }
+            const bool allLayers = view.shift;
+            if (left)   paint(0.0f,   allLayers);
+            if (middle) paint(300.0f, allLayers);
+            if (right)  paint(6000.0f,allLayers);
         }
 
-        // Render with try-lock so we don't stall sim thread; if busy, draw a tiny “updating” banner.
-        bool drew = false;
-        if (std::unique_lock<std::mutex> lk(server.worldMutex, std::try_to_lock); lk.owns_lock()) {
+        if (snap) {
             if (view.mode == RenderMode::WorldMap) {
-                render_world_map(renderer, font, server.world, pausedNow, view, winW, winH);
+                render_world_map(renderer, font, *snap, pausedNow, view, winW, winH);
             } else {
-                render_chunk_view(renderer, font, server.world, pausedNow, view, winW, winH);
+                render_chunk_view(renderer, font, *snap, pausedNow, view, winW, winH);
             }
-            drew = true;
         } else {
-            // lightweight fallback frame
+            // server not started yet
             SDL_SetRenderDrawColor(renderer, 0,0,0,255);
             SDL_RenderClear(renderer);
-            if (font) drawText(renderer, font, "Updating simulation...", 10.0f, 10.0f);
+            if (font) drawText(renderer, font, "Waiting for the first frame...", 10.0f, 10.0f);
         }
 
         SDL_RenderPresent(renderer);
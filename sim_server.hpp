@@ -4,16 +4,236 @@
 #include <condition_variable>
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
 #include "sim_engine.hpp"
+#include "sim_snapshot.hpp"
+#include "sim_tick.hpp"
+
+// ====== Edit commands ======
+// Typed edits from the UI / network. Coordinates are chunk-local (set_cell convention); FillSection
+// uses y as the section index. SetCell and FillSection create the chunk if needed, SetTemperature
+// leaves void cells and missing chunks alone.
+struct SimEdit {
+    enum Kind : uint8_t { SetCell, FillSection, SetTemperature, LoadChunk, UnloadChunk };
+    Kind kind = SetCell;
+    uint16_t mat = 0;
+    int cx = 0, cz = 0;
+    int x = 0, y = 0, z = 0;
+    float T = 0.0f;
+
+    static SimEdit setCell(int cx, int cz, int x, int y, int z, uint16_t mat, float T) { return {SetCell, mat, cx, cz, x, y, z, T}; }
+    static SimEdit fillSection(int cx, int cz, int sy, uint16_t mat, float T)          { return {FillSection, mat, cx, cz, 0, sy, 0, T}; }
+    static SimEdit setTemperature(int cx, int cz, int x, int y, int z, float T)        { return {SetTemperature, 0, cx, cz, x, y, z, T}; }
+    static SimEdit loadChunk(int cx, int cz)                                            { return {LoadChunk, 0, cx, cz}; }
+    static SimEdit unloadChunk(int cx, int cz)                                          { return {UnloadChunk, 0, cx, cz}; }
+};
+
+// Applies one edit; false when it was rejected (material index not in the table).
+inline bool apply_sim_edit(World& world, const SimEdit& e) {
+    switch (e.kind) {
+    case SimEdit::SetCell:
+        if (e.mat >= world.materials.size()) return false;
+        set_cell(*world.ensureChunk(e.cx, e.cz), e.x, e.y, e.z, e.mat, e.T, world.materials);
+        return true;
+    case SimEdit::FillSection:
+        if (e.mat >= world.materials.size()) return false;
+        fill_section_with(*world.ensureChunk(e.cx, e.cz), e.mat, e.T, e.y, world.materials);
+        return true;
+    case SimEdit::SetTemperature:
+        if (Chunk* C = world.findChunk(e.cx, e.cz)) set_cell_temperature(*C, e.x, e.y, e.z, e.T);
+        return true;
+    case SimEdit::LoadChunk:   world.ensureChunk(e.cx, e.cz); return true;
+    case SimEdit::UnloadChunk: world.removeChunk(e.cx, e.cz); return true;
+    }
+    return false;
+}
+
+// Bounded lock-free multi-producer / single-consumer ring (per-slot sequence numbers, Vyukov).
+// Producers never block: try_push fails when the ring is full. A producer preempted between
+// claiming and publishing a slot only holds back the consumer until it finishes.
+template<class T, size_t N>
+class MpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "ring size must be a power of two");
+public:
+    MpscRing() : slots_(new Slot[N]) {
+        for (size_t i = 0; i < N; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(const T& v) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* s;
+        for (;;) {
+            s = &slots_[pos & (N - 1)];
+            const intptr_t d = (intptr_t)s->seq.load(std::memory_order_acquire) - (intptr_t)pos;
+            if (d == 0) { if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break; }
+            else if (d < 0) { dropped_.fetch_add(1, std::memory_order_relaxed); return false; }  // full
+            else pos = head_.load(std::memory_order_relaxed);
+        }
+        s->value = v;
+        s->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    // Consumer only.
+    bool try_pop(T& out) {
+        const size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& s = slots_[pos & (N - 1)];
+        if (s.seq.load(std::memory_order_acquire) != pos + 1) return false;
+        out = s.value;
+        s.seq.store(pos + N, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Claimed slots not yet consumed (approximate while producers run).
+    size_t depth() const {
+        const size_t h = head_.load(std::memory_order_relaxed), t = tail_.load(std::memory_order_relaxed);
+        return h > t ? h - t : 0;
+    }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    struct Slot { std::atomic<size_t> seq; T value; };
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> head_{0};   // producers
+    alignas(64) std::atomic<size_t> tail_{0};   // consumer
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+};
+
+// Structural world changes (chunk insertions/removals, section fills, material additions) from
+// other threads. They are queued here and applied by the sim thread at one point per frame:
+// after compute, before the swap, under worldMutex. So a frame's compute never sees the chunk
+// index or the material table change under it, and readers holding worldMutex see whole batches.
+// Each applied batch advances the epoch. Once the server runs, add materials only through here:
+// addMaterial hands out the index the material will have.
+class WorldChangeQueue {
+public:
+    explicit WorldChangeQueue(const World& world) : world_(world) {}
+
+    void addChunk(int cx, int cz)    { push(Change{Change::AddChunk, cx, cz}); }
+    void removeChunk(int cx, int cz) { push(Change{Change::RemoveChunk, cx, cz}); }
+    // fill_section_with on chunk (cx, cz), created if missing.
+    void fillSection(int cx, int cz, int sy, uint16_t mat_ix, float T) {
+        push(Change{Change::FillSection, cx, cz, sy, mat_ix, T});
+    }
+    uint16_t addMaterial(const Material& m) {
+        std::lock_guard<std::mutex> lk(m_);
+        const uint16_t ix = static_cast<uint16_t>(world_.materials.size() + pendingMaterials_++);
+        pending_.push_back(Change{Change::AddMaterial, 0, 0, 0, ix, 0.0f, m});
+        queued_.store(pending_.size(), std::memory_order_release);
+        return ix;
+    }
+
+    // Sim thread, with worldMutex held. Returns the number of changes applied.
+    size_t apply(World& world) {
+        if (queued_.load(std::memory_order_acquire) == 0) return 0;
+        std::lock_guard<std::mutex> lk(m_);
+        for (const Change& c : pending_) {
+            switch (c.kind) {
+            case Change::AddChunk:    world.ensureChunk(c.cx, c.cz); break;
+            case Change::RemoveChunk: world.removeChunk(c.cx, c.cz); break;
+            case Change::FillSection:
+                fill_section_with(*world.ensureChunk(c.cx, c.cz), c.mat, c.T, c.sy, world.materials);
+                break;
+            case Change::AddMaterial: world.materials.add(c.material); break;
+            }
+        }
+        const size_t n = pending_.size();
+        pending_.clear();
+        pendingMaterials_ = 0;
+        queued_.store(0, std::memory_order_release);
+        lastApplied_.store(n, std::memory_order_relaxed);
+        epoch_.fetch_add(1, std::memory_order_release);
+        return n;
+    }
+
+    uint64_t epoch()       const { return epoch_.load(std::memory_order_acquire); }
+    size_t   pending()     const { return queued_.load(std::memory_order_acquire); }
+    size_t   lastApplied() const { return lastApplied_.load(std::memory_order_relaxed); }
+
+private:
+    struct Change {
+        enum Kind : uint8_t { AddChunk, RemoveChunk, FillSection, AddMaterial } kind;
+        int cx = 0, cz = 0, sy = 0;
+        uint16_t mat = 0;
+        float T = 0.0f;
+        Material material{};
+    };
+    void push(const Change& c) {
+        std::lock_guard<std::mutex> lk(m_);
+        pending_.push_back(c);
+        queued_.store(pending_.size(), std::memory_order_release);
+    }
+
+    const World& world_;
+    std::mutex m_;
+    std::vector<Change> pending_;
+    size_t pendingMaterials_ = 0;
+    std::atomic<size_t>   queued_{0};
+    std::atomic<size_t>   lastApplied_{0};
+    std::atomic<uint64_t> epoch_{0};
+};
+
+// Per-tick reductions, computed on the output lane from the published snapshot.
+struct SimTickStats {
+    uint64_t frame = 0;
+    double worldMs = 0.0;          // sum of chunk_ms_last
+    double maxChunkMs = 0.0;
+    SectionActivity activity;
+    FramePhaseTimes compute;       // prepare / halo / kernel split of the compute phase
+    SnapshotDeltaStats delta;      // last encoded network delta (zero without a sink)
+};
+
+// Fixed-rate schedule telemetry, since the tick rate was last changed or resetScheduleStats().
+struct TickScheduleStats {
+    double   periodMs = 0.0;     // 0 while free-running
+    uint64_t ticks    = 0;
+    uint64_t overruns = 0;       // ticks that ended after their deadline (slot start + period)
+    uint64_t late     = 0;       // ticks whose slot had passed when the loop got to them (catch-up)
+    uint64_t skipped  = 0;       // slots dropped when more than maxCatchUpTicks behind
+    TickHistogram jitter;        // actual - scheduled start
+    TickHistogram compute;       // sim lane time per tick (compute, drain, publish)
+    TickHistogram idle;          // time slept before each tick
+    TickHistogram overrun;       // end - deadline, 0 for ticks on time
+
+    // Fraction of the tick budget spent in the sim lane.
+    double load() const { return ticks && periodMs > 0.0 ? compute.sumMs / (double(ticks) * periodMs) : 0.0; }
+};
 
 // Small server that owns the world and advances it on a background thread.
+// A tick is a TickGraph:
+//   sim lane:    compute (halo exchange + section kernels) -> drain (staged changes, edits)
+//                -> publish (swap + snapshot)
+//   output lane: stats (reductions), encode (network delta); both after publish
+// The output phases of tick N run while tick N+1 computes; compute of tick N waits for the output
+// phases of tick N-2, so the output lane is at most one tick behind.
 class SimServer {
 public:
     World world;
 
-    // Readers (renderer) should lock this mutex to snapshot/draw safely.
+    // Only the sim thread writes `world`, and compute changes its storage (section promotion,
+    // back buffers, halos, in-place T_curr) without this mutex. The mutex only fences drain
+    // (staged changes, edits, swap): holding it keeps the chunk index, materials and sectionLoaded
+    // stable, nothing more. Reading section data or per-chunk stats of the live world needs a
+    // parked sim thread (setPaused(true) returns once it is) or a running() == false server; the
+    // renderer and other frequent readers use snapshot() instead.
     std::mutex worldMutex;
 
+    // Last published frame (null before the first one); never blocks, hold it as long as needed.
+    std::shared_ptr<const WorldSnapshot> snapshot() const { return published.load(std::memory_order_acquire); }
+
+    // Chunk/section/material changes from other threads; applied between compute and swap.
+    WorldChangeQueue changes{world};
+
+    // Cell/section/chunk edits (UI painting, network set_state). pushEdit never blocks; it
+    // returns false when the queue is full. Drained once per tick right after `changes`.
+    static constexpr size_t EDIT_QUEUE_SIZE = 1 << 14;
+    bool pushEdit(const SimEdit& e) { return edits.try_push(e); }
+    uint64_t editsDropped() const { return edits.dropped(); }
+
     // Control
     std::atomic<bool> running{false};
     std::atomic<bool> paused{false};
@@ -22,20 +242,54 @@ public:
     // Optional: micro-pause after each frame to reduce CPU (set 0 for max speed)
     std::atomic<int> sleepMillis{1};
 
+    // Fixed-rate ticking: ticks start on a grid of 1/tickRateHz (0 = free-running with the nap
+    // above). Late slots run back to back; beyond maxCatchUpTicks late ones the backlog is dropped
+    // and the grid moves on.
+    std::atomic<float> tickRateHz{0.0f};
+    std::atomic<int>   maxCatchUpTicks{4};
+
+    // Section compute workers (0 = one per allowed CPU, 1 = serial). Read when the pool is created.
+    int  workerThreads = 0;
+    bool pinWorkers    = false;   // see SimWorkerPool
+
+    // Network output: called on the output lane with each tick's delta against the previous
+    // encoded snapshot (the first one carries the whole world). Set before start().
+    std::function<void(const std::vector<uint8_t>& delta, uint64_t frame)> deltaSink;
+
     // Stats
     std::atomic<uint64_t> framesSimulated{0};
+    std::atomic<uint32_t> editsLastTick{0};      // edits applied by the last drain
+    std::atomic<uint32_t> editsRejectedLastTick{0};
+    std::atomic<uint32_t> editDepthLastTick{0};  // queue depth when the last drain started
 
     SimServer() = default;
-    ~SimServer() { stop(); join(); }
+    ~SimServer() { stop(); join(); graph.stop(); }
+
+    SimTickStats tickStats() const { std::lock_guard<std::mutex> lk(statsMutex); return stats; }
+    // Per-phase run/wait times and critical path of the last tick that went through all lanes.
+    TickGraph::TickStats tickTiming() const { return graph.lastStats(); }
+    TickScheduleStats scheduleStats() const { std::lock_guard<std::mutex> lk(scheduleMutex); return schedule; }
+    void resetScheduleStats() {
+        std::lock_guard<std::mutex> lk(scheduleMutex);
+        const double period = schedule.periodMs;
+        schedule = TickScheduleStats{};
+        schedule.periodMs = period;
+    }
 
     void start() {
         if (running.load()) return;
+        ensurePool();
+        ensureGraph();
+        publishSnapshot(framesSimulated.load());
         running = true;
         worker = std::thread([this]{ this->runLoop(); });
     }
 
     void stop() {
-        running = false;
+        {
+            std::lock_guard<std::mutex> lk(cvMutex);
+            running = false;
+        }
         cv.notify_all();
     }
 
@@ -43,48 +297,154 @@ public:
         if (worker.joinable()) worker.join();
     }
 
+    // Pausing waits until the sim thread is parked between ticks (no compute in flight); while
+    // paused it only drains changes/edits, under worldMutex. Not from a deltaSink (output lane).
     void setPaused(bool p) {
+        std::unique_lock<std::mutex> lk(cvMutex);
         paused = p;
-        if (!p) cv.notify_all();
+        cv.notify_all();
+        if (p) cv.wait(lk, [&]{ return parked || !running.load() || std::this_thread::get_id() == worker.get_id(); });
     }
     bool isPaused() const { return paused.load(); }
 
-    // Manual single step (headless / tests)
+    int workerCount() const { return pool ? pool->size() : 0; }
+
+    // Manual single step (headless / tests); also applies the staged changes.
     void stepOnce() {
-        // Compute without lock
-        compute_frame_to_backbuffers(world, dtSeconds);
-        // Publish with a very short lock
-        {
-            std::unique_lock<std::mutex> lk(worldMutex);
-            swap_all_backbuffers(world);
-        }
-        ++framesSimulated;
+        ensurePool();
+        ensureGraph();
+        runTick(true);
     }
+    // Waits for the output lane (stats, network delta) to catch up.
+    void flushOutput() { graph.drain(); }
 
 private:
     std::thread worker;
     std::condition_variable cv;
     std::mutex cvMutex;
+    bool parked = false;   // cvMutex: the sim thread saw `paused` and computes nothing until it clears
+    std::unique_ptr<SimWorkerPool> pool;
+    MpscRing<SimEdit, EDIT_QUEUE_SIZE> edits;
+    std::shared_ptr<SnapshotPool> snapshotPool = std::make_shared<SnapshotPool>();
+    std::shared_ptr<const WorldSnapshot> lastSnapshot;            // sim thread's reference
+    std::atomic<std::shared_ptr<const WorldSnapshot>> published;
+
+    TickGraph graph;
+    uint64_t tickNo = 0;
+    bool stepThisTick = false;
+    std::shared_ptr<const WorldSnapshot> tickSnap[4];            // publish -> output lane, by tick % 4
+    std::shared_ptr<const WorldSnapshot> lastEncoded;            // output lane: delta baseline
+    std::vector<uint8_t> deltaBuf;
+    mutable std::mutex statsMutex;
+    SimTickStats stats;
+    mutable std::mutex scheduleMutex;
+    TickScheduleStats schedule;
+
+    SimWorkerPool* ensurePool() {
+        if (!pool) pool = std::make_unique<SimWorkerPool>(workerThreads, pinWorkers);
+        return pool.get();
+    }
+
+    void ensureGraph() {
+        if (graph.phaseCount()) return;
+        using Lane = TickGraph::Lane;
+        // Compute without the lock, in place or not (see worldMutex).
+        const int compute = graph.addPhase("compute", Lane::Sim, [this](uint64_t) {
+            if (!stepThisTick) return;
+            compute_frame_to_backbuffers(world, dtSeconds, pool.get());
+        });
+        // Changes go in before the swap: a filled section drops its back buffer (make_uniform)
+        // and a new or released one has ranLast = 0, so the swap skips them.
+        const int drain = graph.addPhase("drain", Lane::Sim, [this](uint64_t) {
+            std::unique_lock<std::mutex> lk(worldMutex);
+            applyStaged();
+            if (stepThisTick && !world_in_place(world)) swap_all_backbuffers(world);
+        }, {compute});
+        // Snapshot without the lock (only this thread writes the world), one atomic store.
+        const int publish = graph.addPhase("publish", Lane::Sim, [this](uint64_t t) {
+            publishSnapshot(framesSimulated.load() + (stepThisTick ? 1 : 0), pool.get());
+            tickSnap[t % 4] = lastSnapshot;
+        }, {drain});
+        const int reduce = graph.addPhase("stats", Lane::Output, [this](uint64_t t) {
+            const WorldSnapshot& snap = *tickSnap[t % 4];
+            double sum = 0.0, mx = 0.0;
+            for (const ChunkSnapshot& C : snap.chunks) { sum += C.chunk_ms_last; mx = std::max(mx, C.chunk_ms_last); }
+            const SectionActivity act = snapshot_activity(snap);
+            std::lock_guard<std::mutex> lk(statsMutex);
+            stats.frame = snap.frame;
+            stats.worldMs = sum;
+            stats.maxChunkMs = mx;
+            stats.activity = act;
+            stats.compute = snap.phases;
+        }, {publish});
+        const int encode = graph.addPhase("encode", Lane::Output, [this](uint64_t t) {
+            std::shared_ptr<const WorldSnapshot> snap = std::move(tickSnap[t % 4]);
+            if (!deltaSink) return;
+            const SnapshotDeltaStats d = encode_snapshot_delta(lastEncoded.get(), *snap, deltaBuf);
+            deltaSink(deltaBuf, snap->frame);
+            lastEncoded = std::move(snap);
+            std::lock_guard<std::mutex> lk(statsMutex);
+            stats.delta = d;
+        }, {publish});
+        graph.addLaggedDep(compute, reduce, 2);
+        graph.addLaggedDep(compute, encode, 2);
+    }
+
+    // One tick through the graph; `step` = advance a frame (false: only changes and a snapshot).
+    void runTick(bool step) {
+        stepThisTick = step;
+        graph.runTick(tickNo++);
+        if (step) ++framesSimulated;
+    }
+
+    void publishSnapshot(uint64_t frame, SimWorkerPool* p = nullptr) {
+        lastSnapshot = build_world_snapshot(world, lastSnapshot.get(), *snapshotPool, frame, changes.epoch(), p);
+        published.store(lastSnapshot, std::memory_order_release);
+    }
+
+    // worldMutex held. Structural changes first, then the edits queued so far: edits pushed
+    // during the drain wait for the next tick, so producers cannot stretch a tick.
+    void applyStaged() {
+        changes.apply(world);
+        const size_t depth = edits.depth();
+        uint32_t applied = 0, rejected = 0;
+        SimEdit e;
+        for (size_t n = 0; n < depth && edits.try_pop(e); ++n) {
+            if (apply_sim_edit(world, e)) ++applied;
+            else                          ++rejected;
+        }
+        editsLastTick.store(applied, std::memory_order_relaxed);
+        editsRejectedLastTick.store(rejected, std::memory_order_relaxed);
+        editDepthLastTick.store((uint32_t)depth, std::memory_order_relaxed);
+    }
 
     void runLoop() {
         using namespace std::chrono_literals;
+        TickSlot slot;
         while (running.load()) {
-            if (paused.load()) {
+            bool pausedNow;
+            {
+                std::lock_guard<std::mutex> lk(cvMutex);
+                pausedNow = paused.load();
+                if (parked != pausedNow) { parked = pausedNow; cv.notify_all(); }
+            }
+            if (pausedNow) {
+                if (changes.pending() || edits.depth()) runTick(false);   // no frames to ride on while paused
                 std::unique_lock<std::mutex> lk(cvMutex);
                 cv.wait_for(lk, 5ms, [&]{ return !paused.load() || !running.load(); });
+                slot.valid = false;   // resume on a fresh grid
                 continue;
             }
 
-            // 1) heavy work WITHOUT the lock
-            compute_frame_to_backbuffers(world, dtSeconds);
-
-            // 2) quick publish WITH the lock (O(1) vector swaps)
-            {
-                std::unique_lock<std::mutex> lk(worldMutex);
-                swap_all_backbuffers(world);
+            const float hz = tickRateHz.load();
+            if (hz > 0.0f) { scheduledTick(hz, slot); continue; }
+            if (slot.valid) {
+                slot.valid = false;
+                std::lock_guard<std::mutex> lk(scheduleMutex);
+                schedule.periodMs = 0.0;
             }
 
-            ++framesSimulated;
+            runTick(true);
 
             // small configurable nap to keep CPU sane (set sleepMillis=0 for flat out)
             int ms = sleepMillis.load();
@@ -92,4 +452,55 @@ private:
             else        std::this_thread::yield();
         }
     }
+
+    using sched_clock = std::chrono::steady_clock;
+    struct TickSlot {
+        bool valid = false;
+        sched_clock::time_point next;     // scheduled start of the next tick
+        sched_clock::duration period{};
+    };
+
+    // One fixed-rate tick: wait for its slot (woken early by stop/pause), run it, record the
+    // timings and advance the grid by one period.
+    void scheduledTick(float hz, TickSlot& slot) {
+        const auto period = std::chrono::duration_cast<sched_clock::duration>(std::chrono::duration<double>(1.0 / hz));
+        const auto t0 = sched_clock::now();
+        if (!slot.valid || slot.period != period) {   // (re)start the grid; a new rate restarts the stats
+            if (slot.period != period) resetScheduleStats();
+            slot = TickSlot{true, t0, period};
+            std::lock_guard<std::mutex> lk(scheduleMutex);
+            schedule.periodMs = std::chrono::duration<double, std::milli>(period).count();
+        }
+        const bool late = slot.next < t0;
+        if (!late) {
+            std::unique_lock<std::mutex> lk(cvMutex);
+            if (cv.wait_until(lk, slot.next, [&]{ return !running.load() || paused.load(); })) return;
+        }
+        const auto start = sched_clock::now();
+        runTick(true);
+        const auto end = sched_clock::now();
+
+        const auto deadline = slot.next + period;
+        slot.next = deadline;
+        uint64_t skipped = 0;
+        if (end > slot.next) {
+            const int64_t behind = (end - slot.next) / period;   // whole slots already missed
+            if (behind > std::max(0, maxCatchUpTicks.load())) {
+                skipped = (uint64_t)behind;
+                slot.next += behind * period;
+            }
+        }
+
+        using ms = std::chrono::duration<double, std::milli>;
+        std::lock_guard<std::mutex> lk(scheduleMutex);
+        ++schedule.ticks;
+        schedule.late += late ? 1 : 0;
+        schedule.skipped += skipped;
+        schedule.jitter.add(ms(start - (deadline - period)).count());
+        schedule.compute.add(ms(end - start).count());
+        schedule.idle.add(ms(start - t0).count());
+        const double over = ms(end - deadline).count();
+        schedule.overrun.add(over);
+        schedule.overruns += over > 0.0 ? 1 : 0;
+    }
 };
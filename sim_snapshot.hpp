@@ -0,0 +1,310 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include "sim_engine.hpp"
+
+// ====== Published world snapshots ======
+// Immutable per-frame views of temperatures, materials and section metadata for readers that must
+// not block the simulation (renderer, network serializer, stats). A snapshot is reference counted;
+// readers keep it as long as they like and the sim thread never waits for them.
+// A dense section's temperatures are its own front buffer (SectionTempBuffer::share), never a
+// copy; the section moves to a fresh pool buffer before writing a shared one. Materials are shared
+// with the previous snapshot while the section was not edited (coeffDirty, still set between the
+// publish step and the next compute) and copied otherwise. So publishing copies edited materials
+// only. Material buffers and whole snapshots return to a SnapshotPool when their last reader drops
+// them, temperature buffers to section_temps_pool().
+
+// Material indices of a dense section at publish time.
+struct SectionMaterials { std::array<uint16_t, SECTION_N> v; };
+
+// Material indices of a published section, with the decode_row/get interface of SectionPalette.
+struct SnapshotMaterials {
+    const uint16_t* cells = nullptr;   // dense: SECTION_N indices; uniform: nullptr
+    uint16_t uniform = 0;
+    uint16_t get(int i) const { return cells ? cells[i] : uniform; }
+    void decode_row(int base, uint16_t* out) const {
+        if (cells) std::memcpy(out, cells + base, CHUNK_W * sizeof(uint16_t));
+        else       std::fill_n(out, CHUNK_W, uniform);
+    }
+};
+
+// Read side of Section: dense, T_row, T_at, matIx.
+struct SectionSnapshot {
+    std::shared_ptr<const SectionTemps>     temps;    // dense only
+    std::shared_ptr<const SectionMaterials> mats;     // dense only
+    SnapshotMaterials matIx;
+    std::array<temp_t, CHUNK_W> uniformRow{};         // uniform only
+    bool dense = false;
+
+    const temp_t* T_row(int base) const { return dense ? temps->v.data() + base : uniformRow.data(); }
+    temp_t T_at(int i) const { return dense ? temps->v[i] : uniformRow[0]; }
+};
+
+// Read side of Chunk: section(sy) plus the per-section metadata the renderer shows.
+struct ChunkSnapshot {
+    int cx = 0, cz = 0;
+    uint16_t void_ix = 0;
+    double chunk_ms_last = 0.0;
+    std::array<double,  SECTIONS_Y> section_ms_last{};
+    std::array<uint8_t, SECTIONS_Y> sectionLoaded{};
+    std::array<uint8_t, SECTIONS_Y> asleep{};
+    std::array<uint8_t, SECTIONS_Y> substeps{};
+    std::array<SectionSnapshot, SECTIONS_Y> sections;
+
+    const SectionSnapshot* section(int sy) const { return sectionLoaded[sy] ? &sections[sy] : nullptr; }
+};
+
+struct WorldSnapshot {
+    uint64_t frame = 0;              // frames simulated when published
+    uint64_t epoch = 0;              // structural-change epoch (WorldChangeQueue) when published
+    SimSolver solver = SimSolver::Explicit;
+    int cgIterations = 0;            // ImplicitPCG, last frame
+    FramePhaseTimes phases;          // compute stages of the last frame
+    std::vector<ChunkSnapshot> chunks;   // sorted by (cz, cx)
+
+    const ChunkSnapshot* find(int cx, int cz) const {
+        const ChunkSnapshot* C = first_at_or_after(cx, cz);
+        return (C && C->cx == cx && C->cz == cz) ? C : nullptr;
+    }
+    // Bounding box of the chunks; false when there are none.
+    bool bounds(int& minCX, int& minCZ, int& maxCX, int& maxCZ) const {
+        if (chunks.empty()) return false;
+        minCZ = chunks.front().cz; maxCZ = chunks.back().cz;
+        minCX = maxCX = chunks.front().cx;
+        for (const ChunkSnapshot& C : chunks) { minCX = std::min(minCX, C.cx); maxCX = std::max(maxCX, C.cx); }
+        return true;
+    }
+    // f(cx, cz, const ChunkSnapshot* or nullptr) for every coordinate of [cx0, cx1] x [cz0, cz1],
+    // z rows then x (ChunkIndex::for_each_in_range order).
+    template<class F> void for_each_in_range(int cx0, int cz0, int cx1, int cz1, F&& f) const {
+        const ChunkSnapshot* end = chunks.data() + chunks.size();
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            const ChunkSnapshot* C = first_at_or_after(cx0, cz);   // then walk the row
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                const bool hit = C && C != end && C->cz == cz && C->cx == cx;
+                f(cx, cz, hit ? C : nullptr);
+                if (hit) ++C;
+            }
+        }
+    }
+
+private:
+    const ChunkSnapshot* first_at_or_after(int cx, int cz) const {
+        auto it = std::lower_bound(chunks.begin(), chunks.end(), std::make_pair(cz, cx),
+            [](const ChunkSnapshot& C, const std::pair<int,int>& k) { return std::make_pair(C.cz, C.cx) < k; });
+        return it == chunks.end() ? nullptr : &*it;
+    }
+};
+
+// Free lists for section material buffers and snapshots. Buffers come back from whichever thread drops the
+// last reference; the lists never hold more than the peak number of live buffers.
+class SnapshotPool : public std::enable_shared_from_this<SnapshotPool> {
+public:
+    ~SnapshotPool() {
+        for (auto* p : freeMats_)  delete p;
+        for (auto* p : freeWorlds_) delete p;
+    }
+
+    std::shared_ptr<SectionMaterials> acquireMaterials() { return acquire(freeMats_); }
+    std::shared_ptr<WorldSnapshot>    acquireWorld()     { return acquire(freeWorlds_); }
+
+    uint64_t reused()    const { return reused_.load(std::memory_order_relaxed); }
+    uint64_t allocated() const { return allocated_.load(std::memory_order_relaxed); }
+
+private:
+    template<class T> std::shared_ptr<T> acquire(std::vector<T*>& list) {
+        T* p = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!list.empty()) { p = list.back(); list.pop_back(); }
+        }
+        if (p) reused_.fetch_add(1, std::memory_order_relaxed);
+        else { p = new T; allocated_.fetch_add(1, std::memory_order_relaxed); }
+        auto self = shared_from_this();
+        return std::shared_ptr<T>(p, [self](T* q) { self->recycle(q); });
+    }
+    void recycle(SectionMaterials* p) { std::lock_guard<std::mutex> lk(m_); freeMats_.push_back(p); }
+    void recycle(WorldSnapshot* s) {
+        s->chunks.clear();   // releases section buffers (re-enters recycle), so outside the lock
+        std::lock_guard<std::mutex> lk(m_);
+        freeWorlds_.push_back(s);
+    }
+
+    std::mutex m_;
+    std::vector<SectionMaterials*> freeMats_;
+    std::vector<WorldSnapshot*>    freeWorlds_;
+    std::atomic<uint64_t> reused_{0}, allocated_{0};
+};
+
+// Snapshot of the world as it is now; `prev` (the last one published, may be null) lends the
+// materials of unedited dense sections. The caller must be the only writer of `world` meanwhile;
+// the dense sections' front buffers are marked shared.
+inline std::shared_ptr<const WorldSnapshot> build_world_snapshot(World& world, const WorldSnapshot* prev,
+                                                                 SnapshotPool& pool, uint64_t frame, uint64_t epoch,
+                                                                 SimWorkerPool* workers = nullptr) {
+    std::shared_ptr<WorldSnapshot> snap = pool.acquireWorld();
+    snap->frame = frame;
+    snap->epoch = epoch;
+    snap->solver = world.solver;
+    snap->cgIterations = world.implicitLast.iterations;
+    snap->phases = world.phaseLast;
+
+    std::vector<Chunk*> order;
+    order.reserve(world.chunks.size());
+    for (const auto& kv : world.chunks) order.push_back(kv.second);
+    std::sort(order.begin(), order.end(), [](const Chunk* a, const Chunk* b) {
+        return a->cz != b->cz ? a->cz < b->cz : a->cx < b->cx;
+    });
+    snap->chunks.resize(order.size());
+
+    auto buildChunk = [&](int t) {
+        Chunk& C = *order[t];
+        ChunkSnapshot& out = snap->chunks[t];
+        const ChunkSnapshot* old = prev ? prev->find(C.cx, C.cz) : nullptr;
+        out.cx = C.cx; out.cz = C.cz;
+        out.void_ix = C.void_ix;
+        out.chunk_ms_last = C.chunk_ms_last;
+        out.section_ms_last = C.section_ms_last;
+        out.sectionLoaded = C.sectionLoaded;
+        out.asleep = C.asleep;
+        out.substeps = C.substeps;
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            Section* S = C.section(sy);
+            SectionSnapshot& s = out.sections[sy];
+            out.sectionLoaded[sy] = S ? 1 : 0;
+            s.dense = S && S->dense;
+            if (!S || !S->dense) {
+                s.temps.reset();
+                s.mats.reset();
+                s.matIx = SnapshotMaterials{nullptr, S ? S->matIx.get(0) : C.void_ix};
+                if (S) s.uniformRow = S->uniformRow;
+                continue;
+            }
+            const SectionSnapshot* o = old ? old->section(sy) : nullptr;
+            s.temps = S->T_curr.share();
+            if (o && o->dense && !C.coeffDirty[sy]) {
+                s.mats = o->mats;
+            } else {
+                std::shared_ptr<SectionMaterials> M = pool.acquireMaterials();
+                for (int base=0; base<SECTION_N; base+=CHUNK_W) S->matIx.decode_row(base, M->v.data() + base);
+                s.mats = std::move(M);
+            }
+            s.matIx = SnapshotMaterials{s.mats->v.data(), 0};
+        }
+    };
+    if (workers) workers->run((int)order.size(), buildChunk);
+    else         for (int t=0; t<(int)order.size(); ++t) buildChunk(t);
+    return snap;
+}
+
+// world_section_activity of the published frame.
+inline SectionActivity snapshot_activity(const WorldSnapshot& snap) {
+    SectionActivity a;
+    for (const ChunkSnapshot& C : snap.chunks)
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const SectionSnapshot* S = C.section(sy);
+            if (!S)             continue;
+            if (!S->dense)      ++a.uniform;
+            else if (C.asleep[sy]) ++a.asleep;
+            else                ++a.awake;
+        }
+    return a;
+}
+
+// ====== Snapshot deltas (network output) ======
+// Binary message with what changed from `prev` (null: everything) to `cur`, host byte order:
+//   u64 frame, u32 records, then per record u8 kind, i32 cx, i32 cz and
+//     DeltaChunkRemoved                     -
+//     DeltaSectionRemoved   u8 sy           -
+//     DeltaSectionUniform   u8 sy           u16 mat, f32 T
+//     DeltaSectionDense     u8 sy           4096 x u16 mat, 4096 x f32 T   (new or materials edited)
+//     DeltaSectionTemps     u8 sy           u16 n, n x (u16 cell, f32 T)   (temperatures only)
+// Sections whose buffers are shared with `prev` are skipped without looking at their cells.
+// A temperature record falls back to DeltaSectionDense when more than DELTA_SPARSE_MAX cells changed.
+enum SnapshotDeltaKind : uint8_t {
+    DeltaChunkRemoved = 0, DeltaSectionRemoved, DeltaSectionUniform, DeltaSectionDense, DeltaSectionTemps
+};
+constexpr int DELTA_SPARSE_MAX = SECTION_N / 3;   // (u16 + f32) per cell vs 6 bytes per cell
+
+struct SnapshotDeltaStats { size_t bytes = 0, records = 0, sectionsSkipped = 0; };
+
+inline SnapshotDeltaStats encode_snapshot_delta(const WorldSnapshot* prev, const WorldSnapshot& cur, std::vector<uint8_t>& out) {
+    auto put = [&](const auto& v) {
+        const size_t at = out.size();
+        out.resize(at + sizeof(v));
+        std::memcpy(out.data() + at, &v, sizeof(v));
+    };
+    auto head = [&](SnapshotDeltaKind k, int cx, int cz) { put(uint8_t(k)); put(int32_t(cx)); put(int32_t(cz)); };
+
+    SnapshotDeltaStats st;
+    out.clear();
+    put(uint64_t(cur.frame));
+    const size_t countAt = out.size();
+    put(uint32_t(0));
+
+    static const ChunkSnapshot EMPTY{};
+    std::vector<uint16_t> changed;
+    changed.reserve(SECTION_N);
+    auto chunkDelta = [&](const ChunkSnapshot& C, const ChunkSnapshot& P) {
+        for (int sy=0; sy<SECTIONS_Y; ++sy) {
+            const SectionSnapshot* S = C.section(sy);
+            const SectionSnapshot* O = P.section(sy);
+            if (!S) {
+                if (O) { head(DeltaSectionRemoved, C.cx, C.cz); put(uint8_t(sy)); ++st.records; }
+                continue;
+            }
+            if (!S->dense) {
+                const uint16_t mat = S->matIx.get(0);
+                if (O && !O->dense && O->matIx.get(0) == mat && O->uniformRow[0] == S->uniformRow[0]) { ++st.sectionsSkipped; continue; }
+                head(DeltaSectionUniform, C.cx, C.cz); put(uint8_t(sy)); put(mat); put(temp_decode(S->uniformRow[0]));
+                ++st.records;
+                continue;
+            }
+            const bool sameMats = O && O->dense && O->mats == S->mats;
+            if (sameMats && O->temps == S->temps) { ++st.sectionsSkipped; continue; }
+            if (sameMats) {
+                changed.clear();
+                for (int i=0; i<SECTION_N && (int)changed.size() <= DELTA_SPARSE_MAX; ++i)
+                    if (S->temps->v[i] != O->temps->v[i]) changed.push_back(uint16_t(i));
+                if (changed.empty()) { ++st.sectionsSkipped; continue; }
+                if ((int)changed.size() <= DELTA_SPARSE_MAX) {
+                    head(DeltaSectionTemps, C.cx, C.cz); put(uint8_t(sy)); put(uint16_t(changed.size()));
+                    for (uint16_t i : changed) { put(i); put(temp_decode(S->temps->v[i])); }
+                    ++st.records;
+                    continue;
+                }
+            }
+            head(DeltaSectionDense, C.cx, C.cz); put(uint8_t(sy));
+            const size_t at = out.size();
+            out.resize(at + SECTION_N * (sizeof(uint16_t) + sizeof(float)));
+            std::memcpy(out.data() + at, S->mats->v.data(), SECTION_N * sizeof(uint16_t));
+            uint8_t* T = out.data() + at + SECTION_N * sizeof(uint16_t);
+            for (int c=0; c<SECTION_N; ++c) { const float t = temp_decode(S->temps->v[c]); std::memcpy(T + c * sizeof(float), &t, sizeof(float)); }
+            ++st.records;
+        }
+    };
+
+    // Both chunk lists are sorted by (cz, cx): merge them.
+    const std::vector<ChunkSnapshot> none;
+    const std::vector<ChunkSnapshot>& pc = prev ? prev->chunks : none;
+    size_t i = 0, j = 0;
+    while (i < cur.chunks.size() || j < pc.size()) {
+        const ChunkSnapshot* C = i < cur.chunks.size() ? &cur.chunks[i] : nullptr;
+        const ChunkSnapshot* P = j < pc.size() ? &pc[j] : nullptr;
+        if (C && P && C->cz == P->cz && C->cx == P->cx) { chunkDelta(*C, *P); ++i; ++j; }
+        else if (C && (!P || std::make_pair(C->cz, C->cx) < std::make_pair(P->cz, P->cx))) { chunkDelta(*C, EMPTY); ++i; }
+        else { head(DeltaChunkRemoved, P->cx, P->cz); ++st.records; ++j; }
+    }
+
+    const uint32_t n = uint32_t(st.records);
+    std::memcpy(out.data() + countAt, &n, sizeof(n));
+    st.bytes = out.size();
+    return st;
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+
+// ====== Tick task graph ======
+// A tick is a fixed set of phases with dependencies. A phase runs on one of two lanes: the sim
+// lane (the thread calling runTick) or the output lane (a thread owned by the graph); each lane
+// runs its phases in registration order, tick after tick. A phase of tick N starts when its
+// dependencies of tick N are done and, for a lagged dependency (dep, lag), when dep of tick
+// N - lag is done. So output phases of tick N overlap sim phases of tick N+1, and lags bound how
+// far one lane may run ahead of the other.
+// Per phase the graph records run time, time spent waiting on dependencies and whether it lies on
+// the tick's critical path (longest chain of same-tick dependencies by run time).
+class TickGraph {
+public:
+    enum class Lane : uint8_t { Sim, Output };
+    using Fn = std::function<void(uint64_t tick)>;
+
+    struct PhaseStats {
+        const char* name = "";
+        Lane   lane = Lane::Sim;
+        double startMs = 0.0;    // from the start of the tick
+        double ms      = 0.0;    // run time
+        double waitMs  = 0.0;    // lane idle, waiting on dependencies
+        bool   critical = false;
+    };
+    struct TickStats {
+        uint64_t tick = 0;
+        double criticalMs = 0.0;   // run time along the critical path
+        double latencyMs  = 0.0;   // tick start to the end of its last phase
+        std::vector<PhaseStats> phases;
+    };
+
+    TickGraph() = default;
+    ~TickGraph() { stop(); }
+    TickGraph(const TickGraph&) = delete;
+    TickGraph& operator=(const TickGraph&) = delete;
+
+    // Setup, before the first runTick. Dependencies must be registered earlier; lagged ones may
+    // name any phase (addLaggedDep).
+    int addPhase(const char* name, Lane lane, Fn fn, std::vector<int> deps = {}) {
+        phases_.push_back(Phase{name, lane, std::move(fn), std::move(deps), {}});
+        return (int)phases_.size() - 1;
+    }
+    void addLaggedDep(int phase, int dep, int lag) { phases_[phase].lagged.push_back({dep, lag}); }
+
+    // Sim lane: runs the sim phases of `tick` here and hands the tick to the output lane. Ticks
+    // must increase by one per call. Returns when the sim phases are done.
+    void runTick(uint64_t tick) {
+        start(tick);
+        Slot& s = slot(tick);
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            // slot reuse: the tick RING earlier must be fully recorded
+            cv_.wait(lk, [&]{ return tick < first_ + RING || finished_ >= tick - RING + 1; });
+            s.tick = tick;
+            s.t0 = clock::now();
+            s.rec.assign(phases_.size(), Record{});
+        }
+        runLane(Lane::Sim, tick, s);
+        std::lock_guard<std::mutex> lk(m_);
+        if (!hasOutput_) finish(tick, s);
+        else             pending_.push_back(tick);
+        cv_.notify_all();
+    }
+
+    // Waits until every handed-over tick went through the output lane.
+    void drain() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&]{ return pending_.empty() && !outputBusy_; });
+    }
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            quit_ = true;
+        }
+        cv_.notify_all();
+        if (output_.joinable()) output_.join();
+    }
+
+    TickStats lastStats() const { std::lock_guard<std::mutex> lk(m_); return last_; }
+    size_t phaseCount() const { return phases_.size(); }
+
+private:
+    using clock = std::chrono::steady_clock;
+    static constexpr uint64_t RING = 8;   // ticks in flight (bounds any lag)
+
+    struct Phase {
+        const char* name;
+        Lane lane;
+        Fn fn;
+        std::vector<int> deps;
+        std::vector<std::pair<int,int>> lagged;
+    };
+    struct Record { double start = 0.0, end = 0.0, wait = 0.0; };
+    struct Slot { uint64_t tick = 0; clock::time_point t0; std::vector<Record> rec; };
+
+    Slot& slot(uint64_t tick) { return slots_[tick % RING]; }
+    static double ms(clock::time_point a, clock::time_point b) { return std::chrono::duration<double, std::milli>(b - a).count(); }
+
+    void start(uint64_t tick) {
+        if (started_) return;
+        started_ = true;
+        first_ = tick;
+        done_.assign(phases_.size(), 0);
+        for (const Phase& p : phases_) hasOutput_ |= p.lane == Lane::Output;
+        if (hasOutput_) output_ = std::thread([this]{ outputLoop(); });
+    }
+
+    // m_ held. done_ holds tick + 1 of the last completed tick per phase.
+    bool ready(const Phase& p, uint64_t tick) const {
+        for (int d : p.deps) if (done_[d] < tick + 1) return false;
+        for (auto [d, lag] : p.lagged)
+            if (tick >= first_ + (uint64_t)lag && done_[d] < tick - lag + 1) return false;
+        return true;
+    }
+
+    void runLane(Lane lane, uint64_t tick, Slot& s) {
+        for (size_t i = 0; i < phases_.size(); ++i) {
+            const Phase& p = phases_[i];
+            if (p.lane != lane) continue;
+            const auto w0 = clock::now();
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cv_.wait(lk, [&]{ return ready(p, tick); });
+            }
+            const auto r0 = clock::now();
+            p.fn(tick);
+            const auto r1 = clock::now();
+            std::lock_guard<std::mutex> lk(m_);
+            s.rec[i] = Record{ms(s.t0, r0), ms(s.t0, r1), ms(w0, r0)};
+            done_[i] = tick + 1;
+            cv_.notify_all();
+        }
+    }
+
+    void outputLoop() {
+        for (;;) {
+            uint64_t tick;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cv_.wait(lk, [&]{ return quit_ || !pending_.empty(); });
+                if (pending_.empty()) return;   // quit with nothing left
+                tick = pending_.front();
+                pending_.pop_front();
+                outputBusy_ = true;
+            }
+            Slot& s = slot(tick);
+            runLane(Lane::Output, tick, s);
+            std::lock_guard<std::mutex> lk(m_);
+            finish(tick, s);
+            outputBusy_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    // m_ held: critical path and published stats of a completed tick.
+    void finish(uint64_t tick, const Slot& s) {
+        const size_t n = phases_.size();
+        std::vector<double> cp(n, 0.0);
+        std::vector<int> via(n, -1);
+        int tail = -1;
+        TickStats t;
+        t.tick = tick;
+        t.phases.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            const Record& r = s.rec[i];
+            for (int d : phases_[i].deps) if (cp[d] > cp[i]) { cp[i] = cp[d]; via[i] = d; }
+            cp[i] += r.end - r.start;
+            if (tail < 0 || cp[i] > cp[tail]) tail = (int)i;
+            t.phases[i] = PhaseStats{phases_[i].name, phases_[i].lane, r.start, r.end - r.start, r.wait, false};
+            t.latencyMs = std::max(t.latencyMs, r.end);
+        }
+        if (tail >= 0) t.criticalMs = cp[tail];
+        for (int i = tail; i >= 0; i = via[i]) t.phases[i].critical = true;
+        last_ = std::move(t);
+        finished_ = tick + 1;
+    }
+
+    std::vector<Phase> phases_;
+    bool started_ = false, hasOutput_ = false;
+    uint64_t first_ = 0;
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::vector<uint64_t> done_;
+    std::deque<uint64_t> pending_;   // ticks waiting for the output lane
+    bool outputBusy_ = false, quit_ = false;
+    uint64_t finished_ = 0;          // tick + 1 of the last recorded tick
+    Slot slots_[RING];
+    TickStats last_;
+    std::thread output_;
+};
+
+// ====== Tick time histogram ======
+// Log-bucketed durations: 1 us buckets below 8 us, then 8 buckets per power of two (<= 12.5%
+// bucket width) up to ~2^40 us. Percentiles report the bucket's upper edge, clamped to the exact
+// max, so they never understate (an all-zero histogram reports 0).
+struct TickHistogram {
+    static constexpr int SUB = 8;
+    static constexpr int BUCKETS = SUB + 38 * SUB;
+
+    uint32_t bins[BUCKETS] = {};
+    uint64_t count = 0;
+    double sumMs = 0.0;
+    double maxMs = 0.0;
+
+    void add(double ms) {
+        if (ms < 0.0) ms = 0.0;
+        ++bins[bucket(uint64_t(ms * 1000.0))];
+        ++count;
+        sumMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+    void clear() { *this = TickHistogram{}; }
+
+    double meanMs() const { return count ? sumMs / double(count) : 0.0; }
+    // p in [0, 1]
+    double percentileMs(double p) const {
+        if (!count) return 0.0;
+        const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(p * double(count))));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            seen += bins[b];
+            if (seen >= rank) return std::min(maxMs, upperUs(b) / 1000.0);
+        }
+        return maxMs;
+    }
+
+private:
+    static int bucket(uint64_t us) {
+        if (us < SUB) return (int)us;
+        int e = 63 - __builtin_clzll(us);                       // us in [2^e, 2^(e+1)), e >= 3
+        const int b = (e - 2) * SUB + int((us >> (e - 3)) & (SUB - 1));
+        return std::min(b, BUCKETS - 1);
+    }
+    static double upperUs(int b) {
+        if (b < SUB) return double(b + 1);                      // [b, b+1) us
+        const int e = b / SUB + 2, sub = b % SUB;
+        return double(uint64_t(SUB + sub + 1) << (e - 3));
+    }
+};